@@ -69,20 +69,34 @@
  *----------------------------------------------------------*/
 
 #define configUSE_PREEMPTION		1 
-#define configUSE_IDLE_HOOK			0
+#define configUSE_IDLE_HOOK			1
 #define configUSE_TICK_HOOK			0
 #define configCPU_CLOCK_HZ			( ( unsigned long ) 8000000 )
 #define configTICK_RATE_HZ			( ( portTickType ) 1000 )
-#define configMAX_PRIORITIES		( ( unsigned portBASE_TYPE ) 8 )
-#define configMINIMAL_STACK_SIZE	( ( unsigned short ) 85 )
-#define configTOTAL_HEAP_SIZE		( (size_t ) ( 1200 ) )
-#define configMAX_TASK_NAME_LEN		( 20 )
+#define configMAX_PRIORITIES		( 8 )
+#define configMINIMAL_STACK_SIZE	( ( unsigned short ) 100 )
+/* no heap, all tasks and semaphores are static (see configSUPPORT_STATIC_ALLOCATION) */
+#define configTOTAL_HEAP_SIZE		( (size_t ) ( 0 ) )
+#define configMAX_TASK_NAME_LEN		( 8 )
 #define configUSE_TRACE_FACILITY	0
 #define configUSE_16_BIT_TICKS		1
 #define configIDLE_SHOULD_YIELD		1
 #define configQUEUE_REGISTRY_SIZE	0
 #define configUSE_COUNTING_SEMAPHORES       0
 #define configUSE_MUTEXES	0
+#define configUSE_TASK_NOTIFICATIONS	1
+#define configUSE_PORT_OPTIMISED_TASK_SELECTION	1
+#define configUSE_TICKLESS_IDLE		1
+/* the idle task does not sleep while the idle hook has work left, the end of
+ * an EEPROM write raises no interrupt to wake it up */
+extern unsigned char ucApplicationIdleHookBusy( void );
+#define configPRE_SLEEP_PROCESSING( xExpectedIdleTime )	do { if( ucApplicationIdleHookBusy() != 0 ) { ( xExpectedIdleTime ) = 0; } } while( 0 )
+#define configSUPPORT_STATIC_ALLOCATION		1
+#define configSUPPORT_DYNAMIC_ALLOCATION	0
+/* checks the last 16 bytes of the fill pattern at each context switch */
+#define configCHECK_FOR_STACK_OVERFLOW	2
+/* per task run time in timer 1 counts ('R' terminal command) */
+#define configGENERATE_RUN_TIME_STATS	1
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES 		1
 #define configMAX_CO_ROUTINE_PRIORITIES ( 2 )
@@ -104,11 +118,16 @@ Data:       1804 bytes (88.1% Full)
 #define INCLUDE_eTaskGetState			0
 #define INCLUDE_vTaskDelete				1
 #define INCLUDE_vTaskCleanUpResources	0
-#define INCLUDE_vTaskSuspend			0
+#define INCLUDE_vTaskSuspend			1
 #define INCLUDE_vTaskDelayUntil			0
 #define INCLUDE_vTaskDelay				1
+#define INCLUDE_uxTaskGetStackHighWaterMark	1
+#define INCLUDE_pcTaskGetTaskName		1
 #define INCLUDE_vSemaphoreCreateBinary          1
 #define INCLUDE_xSemaphoreGive					1
 #define INCLUDE_xSemaphoreTake					1
 
+/* kernel trace hooks of the trace recorder ('T' terminal command) */
+#include "trace.h"
+
 #endif /* FREERTOS_CONFIG_H */
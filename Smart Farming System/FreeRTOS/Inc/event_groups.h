@@ -171,6 +171,36 @@ typedef TickType_t EventBits_t;
  */
 EventGroupHandle_t xEventGroupCreate( void ) PRIVILEGED_FUNCTION;
 
+/**
+ * event_groups.h
+ *<pre>
+ EventGroupHandle_t xEventGroupCreateStatic( StaticEventGroup_t *pxEventGroupBuffer );
+ </pre>
+ *
+ * Create a new event group in memory provided by the application instead of
+ * the heap.  configSUPPORT_STATIC_ALLOCATION must be set to 1 in
+ * FreeRTOSConfig.h for this function to be available.
+ *
+ * @param pxEventGroupBuffer Must point to a StaticEventGroup_t variable, used
+ * to hold the event group.
+ *
+ * @return The handle of the created event group, or NULL if
+ * pxEventGroupBuffer is NULL.
+ *
+ * Example usage:
+   <pre>
+	static StaticEventGroup_t xEventGroupBuffer;
+	EventGroupHandle_t xEventGroup;
+
+	xEventGroup = xEventGroupCreateStatic( &xEventGroupBuffer );
+   </pre>
+ * \defgroup xEventGroupCreateStatic xEventGroupCreateStatic
+ * \ingroup EventGroup
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	EventGroupHandle_t xEventGroupCreateStatic( StaticEventGroup_t *pxEventGroupBuffer ) PRIVILEGED_FUNCTION;
+#endif
+
 /**
  * event_groups.h
  *<pre>
@@ -84,6 +84,10 @@ include path. */
 	typedef void ( __interrupt __far *pxISR )();
 #endif
 
+#ifdef SFS_SIM_PORT
+	#include "../../sim/port/portmacro.h"
+#endif
+
 #ifdef GCC_MEGA_AVR
 	#include "../portable/GCC/ATMega323/portmacro.h"
 #endif
@@ -133,6 +133,48 @@ extern void vPortYield( void ) __attribute__ ( ( naked ) );
 #define portYIELD()					vPortYield()
 /*-----------------------------------------------------------*/
 
+/* Tickless idle, the tick is suppressed and the CPU sleeps while no task needs
+to run. */
+#if ( configUSE_TICKLESS_IDLE == 1 )
+	extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+/*-----------------------------------------------------------*/
+
+/* Run time statistics, timer 1 already runs for the tick so it needs no set
+up, the counter is the timer 1 counts since the scheduler started. */
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+	extern uint32_t ulPortGetRunTimeCounter( void );
+	#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+	#define portGET_RUN_TIME_COUNTER_VALUE() ulPortGetRunTimeCounter()
+#endif
+/*-----------------------------------------------------------*/
+
+/* Port optimised task selection, the ready priorities are kept as a bit map
+in uxTopReadyPriority and the highest one is read from a table in flash. */
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+
+	#include <avr/pgmspace.h>
+
+	/* Check the configuration. */
+	#if( configMAX_PRIORITIES > 8 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 8.
+	#endif
+
+	extern const uint8_t ucPortPriorityBit[ 8 ] PROGMEM;
+	extern const uint8_t ucPortHighestBit[ 256 ] PROGMEM;
+
+	/* Store/clear the ready priorities in a bit map. */
+	#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= pgm_read_byte( &ucPortPriorityBit[ ( uxPriority ) ] )
+	#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ( UBaseType_t ) ~pgm_read_byte( &ucPortPriorityBit[ ( uxPriority ) ] )
+
+	/*-----------------------------------------------------------*/
+
+	#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = pgm_read_byte( &ucPortHighestBit[ ( uxReadyPriorities ) ] )
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+/*-----------------------------------------------------------*/
+
 /* Task function macros as described on the FreeRTOS.org WEB site. */
 #define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
 #define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
@@ -181,6 +181,36 @@ typedef QueueHandle_t SemaphoreHandle_t;
  */
 #define xSemaphoreCreateBinary() xQueueGenericCreate( ( UBaseType_t ) 1, semSEMAPHORE_QUEUE_ITEM_LENGTH, queueQUEUE_TYPE_BINARY_SEMAPHORE )
 
+/**
+ * semphr. h
+ * <pre>SemaphoreHandle_t xSemaphoreCreateBinaryStatic( StaticSemaphore_t *pxSemaphoreBuffer )</pre>
+ *
+ * Same as xSemaphoreCreateBinary() but the semaphore is held in memory
+ * provided by the application, normally a file scope StaticSemaphore_t, so
+ * nothing is taken from the heap.  configSUPPORT_STATIC_ALLOCATION must be set
+ * to 1 in FreeRTOSConfig.h for this macro to be available.
+ *
+ * @param pxSemaphoreBuffer Must point to a StaticSemaphore_t variable.
+ *
+ * @return The handle of the semaphore, or NULL if pxSemaphoreBuffer is NULL.
+ *
+ * Example usage:
+ <pre>
+ static StaticSemaphore_t xSemaphoreBuffer;
+ SemaphoreHandle_t xSemaphore = NULL;
+
+ void vATask( void * pvParameters )
+ {
+    xSemaphore = xSemaphoreCreateBinaryStatic( &xSemaphoreBuffer );
+ }
+ </pre>
+ * \defgroup xSemaphoreCreateBinaryStatic xSemaphoreCreateBinaryStatic
+ * \ingroup Semaphores
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	#define xSemaphoreCreateBinaryStatic( pxSemaphoreBuffer ) xQueueGenericCreateStatic( ( UBaseType_t ) 1, semSEMAPHORE_QUEUE_ITEM_LENGTH, NULL, ( pxSemaphoreBuffer ), queueQUEUE_TYPE_BINARY_SEMAPHORE )
+#endif
+
 /**
  * semphr. h
  * <pre>xSemaphoreTake(
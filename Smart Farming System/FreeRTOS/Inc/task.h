@@ -114,6 +114,16 @@ typedef enum
 	eDeleted		/* The task being queried has been deleted, but its TCB has not yet been freed. */
 } eTaskState;
 
+/* Actions that can be performed when xTaskNotify() is called. */
+typedef enum
+{
+	eNoAction = 0,				/* Notify the task without updating its notify value. */
+	eSetBits,					/* Set bits in the task's notification value. */
+	eIncrement,					/* Increment the task's notification value. */
+	eSetValueWithOverwrite,		/* Set the task's notification value to a specific value even if the previous value has not yet been read by the task. */
+	eSetValueWithoutOverwrite	/* Set the task's notification value if the previous value has been read by the task. */
+} eNotifyAction;
+
 /*
  * Used internally only.
  */
@@ -329,6 +339,63 @@ is used in assert() statements. */
  */
 #define xTaskCreate( pvTaskCode, pcName, usStackDepth, pvParameters, uxPriority, pxCreatedTask ) xTaskGenericCreate( ( pvTaskCode ), ( pcName ), ( usStackDepth ), ( pvParameters ), ( uxPriority ), ( pxCreatedTask ), ( NULL ), ( NULL ) )
 
+/**
+ * task. h
+ *<pre>
+ TaskHandle_t xTaskCreateStatic(
+							  TaskFunction_t pvTaskCode,
+							  const char * const pcName,
+							  uint16_t usStackDepth,
+							  void *pvParameters,
+							  UBaseType_t uxPriority,
+							  StackType_t * const puxStackBuffer,
+							  StaticTask_t * const pxTaskBuffer
+						  );</pre>
+ *
+ * Create a new task using memory provided by the application instead of the
+ * heap.  configSUPPORT_STATIC_ALLOCATION must be set to 1 in FreeRTOSConfig.h
+ * for this function to be available.
+ *
+ * The stack and the TCB are normally file scope variables, so the linker
+ * places them and the RAM they use shows in the .bss size at build time.
+ * The memory must stay valid for the whole life of the task.
+ *
+ * @param pvTaskCode, pcName, usStackDepth, pvParameters, uxPriority See
+ * xTaskCreate().
+ *
+ * @param puxStackBuffer Must point to an array of at least usStackDepth
+ * StackType_t items, used as the task stack.
+ *
+ * @param pxTaskBuffer Must point to a StaticTask_t variable, used to hold the
+ * task control block.
+ *
+ * @return The handle of the created task, or NULL if either buffer is NULL.
+ *
+ * Example usage:
+   <pre>
+ static StackType_t xStack[ 100 ];
+ static StaticTask_t xTaskBuffer;
+
+ void vOtherFunction( void )
+ {
+ TaskHandle_t xHandle;
+
+	 xHandle = xTaskCreateStatic( vTaskCode, "NAME", 100, NULL, tskIDLE_PRIORITY, xStack, &xTaskBuffer );
+ }
+   </pre>
+ *
+ * When configSUPPORT_STATIC_ALLOCATION is 1 the application must also provide
+ * the memory of the idle task by implementing:
+ *
+ * void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint16_t *pusIdleTaskStackSize );
+ *
+ * \defgroup xTaskCreateStatic xTaskCreateStatic
+ * \ingroup Tasks
+ */
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	TaskHandle_t xTaskCreateStatic( TaskFunction_t pxTaskCode, const char * const pcName, const uint16_t usStackDepth, void * const pvParameters, UBaseType_t uxPriority, StackType_t * const puxStackBuffer, StaticTask_t * const pxTaskBuffer ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
+#endif
+
 /**
  * task. h
  *<pre>
@@ -1087,6 +1154,29 @@ UBaseType_t uxTaskGetNumberOfTasks( void ) PRIVILEGED_FUNCTION;
  */
 char *pcTaskGetTaskName( TaskHandle_t xTaskToQuery ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 
+/**
+ * task.h
+ * <PRE>uint32_t ulTaskGetRunTimeCounter( TaskHandle_t xTask );</PRE>
+ *
+ * configGENERATE_RUN_TIME_STATS must be set to 1 in FreeRTOSConfig.h for this
+ * function to be available.
+ *
+ * Returns the time the task has spent in the Running state, in the units of
+ * portGET_RUN_TIME_COUNTER_VALUE().  Unlike uxTaskGetSystemState() it does not
+ * need configUSE_TRACE_FACILITY or a TaskStatus_t array, so it suits small
+ * RAM targets that know their task handles.  The time of the slice the
+ * calling task is running in is only added at the next context switch.
+ *
+ * @param xTask The handle of the task being queried.  Passing NULL queries
+ * the calling task.
+ *
+ * @return The run time counter of the task.
+ *
+ * \defgroup ulTaskGetRunTimeCounter ulTaskGetRunTimeCounter
+ * \ingroup TaskUtils
+ */
+uint32_t ulTaskGetRunTimeCounter( TaskHandle_t xTask ) PRIVILEGED_FUNCTION;
+
 /**
  * task.h
  * <PRE>UBaseType_t uxTaskGetStackHighWaterMark( TaskHandle_t xTask );</PRE>
@@ -1358,6 +1448,128 @@ void vTaskList( char * pcWriteBuffer ) PRIVILEGED_FUNCTION; /*lint !e971 Unquali
  */
 void vTaskGetRunTimeStats( char *pcWriteBuffer ) PRIVILEGED_FUNCTION; /*lint !e971 Unqualified char types are allowed for strings and single characters only. */
 
+/**
+ * task. h
+ * <PRE>BaseType_t xTaskNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction );</PRE>
+ *
+ * configUSE_TASK_NOTIFICATIONS must be undefined or defined as 1 for this
+ * function to be available.
+ *
+ * Each task has a 32-bit notification value and a notification state held in
+ * its TCB.  Sending a notification to a task unblocks it if it is blocked in
+ * xTaskNotifyWait() or ulTaskNotifyTake(), without the queue or event group
+ * objects otherwise needed to signal between tasks.  A task can only have one
+ * pending notification, so a notification can replace a binary semaphore, a
+ * counting semaphore, an event group or a single item mailbox when there is
+ * only one task receiving the event.
+ *
+ * @param xTaskToNotify The handle of the task being notified.
+ *
+ * @param ulValue Data that can be sent with the notification, how it is used
+ * depends on eAction.
+ *
+ * @param eAction eSetBits ORs ulValue into the notification value, eIncrement
+ * increments the notification value (ulValue is not used),
+ * eSetValueWithOverwrite sets the notification value to ulValue,
+ * eSetValueWithoutOverwrite sets the notification value to ulValue only if the
+ * task has no pending notification, and eNoAction only notifies the task.
+ *
+ * @return pdFAIL if eAction is eSetValueWithoutOverwrite and the task already
+ * had a pending notification, otherwise pdPASS.
+ *
+ * \defgroup xTaskNotify xTaskNotify
+ * \ingroup TaskNotifications
+ */
+BaseType_t xTaskGenericNotify( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction ) PRIVILEGED_FUNCTION;
+#define xTaskNotify( xTaskToNotify, ulValue, eAction ) xTaskGenericNotify( ( xTaskToNotify ), ( ulValue ), ( eAction ) )
+
+/**
+ * task. h
+ * <PRE>BaseType_t xTaskNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken );</PRE>
+ *
+ * A version of xTaskNotify() that can be used from an interrupt service
+ * routine.
+ *
+ * @param pxHigherPriorityTaskWoken Set to pdTRUE if the notification unblocked
+ * a task with a priority above the running task, in which case a context
+ * switch should be requested before the interrupt exits.
+ *
+ * \defgroup xTaskNotifyFromISR xTaskNotifyFromISR
+ * \ingroup TaskNotifications
+ */
+BaseType_t xTaskGenericNotifyFromISR( TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+#define xTaskNotifyFromISR( xTaskToNotify, ulValue, eAction, pxHigherPriorityTaskWoken ) xTaskGenericNotifyFromISR( ( xTaskToNotify ), ( ulValue ), ( eAction ), ( pxHigherPriorityTaskWoken ) )
+
+/**
+ * task. h
+ * <PRE>BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait );</pre>
+ *
+ * Wait, with an optional timeout, for the calling task to receive a
+ * notification.
+ *
+ * @param ulBitsToClearOnEntry Bits cleared in the notification value on entry
+ * when no notification is pending.
+ *
+ * @param ulBitsToClearOnExit Bits cleared in the notification value before
+ * returning when a notification was received.
+ *
+ * @param pulNotificationValue Receives the notification value before the
+ * ulBitsToClearOnExit bits are cleared, can be NULL.
+ *
+ * @param xTicksToWait The maximum time to wait in the Blocked state.
+ *
+ * @return pdTRUE if a notification was received, pdFALSE on timeout.
+ *
+ * \defgroup xTaskNotifyWait xTaskNotifyWait
+ * \ingroup TaskNotifications
+ */
+BaseType_t xTaskNotifyWait( uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit, uint32_t *pulNotificationValue, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <PRE>BaseType_t xTaskNotifyGive( TaskHandle_t xTaskToNotify );</PRE>
+ *
+ * Increment the notification value of a task, a lighter alternative to
+ * xSemaphoreGive() when the notification value is used as a binary or
+ * counting semaphore taken with ulTaskNotifyTake().
+ *
+ * \defgroup xTaskNotifyGive xTaskNotifyGive
+ * \ingroup TaskNotifications
+ */
+#define xTaskNotifyGive( xTaskToNotify ) xTaskGenericNotify( ( xTaskToNotify ), ( 0 ), eIncrement )
+
+/**
+ * task. h
+ * <PRE>void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken );</PRE>
+ *
+ * A version of xTaskNotifyGive() that can be used from an interrupt service
+ * routine.
+ *
+ * \defgroup vTaskNotifyGiveFromISR vTaskNotifyGiveFromISR
+ * \ingroup TaskNotifications
+ */
+void vTaskNotifyGiveFromISR( TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken ) PRIVILEGED_FUNCTION;
+
+/**
+ * task. h
+ * <PRE>uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait );</pre>
+ *
+ * Wait for the notification value of the calling task to be non zero, then
+ * clear it (binary semaphore) or decrement it (counting semaphore).
+ *
+ * @param xClearCountOnExit pdTRUE to clear the notification value on exit,
+ * pdFALSE to decrement it.
+ *
+ * @param xTicksToWait The maximum time to wait in the Blocked state.
+ *
+ * @return The notification value before it was cleared or decremented, zero
+ * on timeout.
+ *
+ * \defgroup ulTaskNotifyTake ulTaskNotifyTake
+ * \ingroup TaskNotifications
+ */
+uint32_t ulTaskNotifyTake( BaseType_t xClearCountOnExit, TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
 /*-----------------------------------------------------------
  * SCHEDULER INTERNALS AVAILABLE FOR PORTING PURPOSES
  *----------------------------------------------------------*/
@@ -115,8 +115,19 @@ typedef struct xEventGroupDefinition
 		UBaseType_t uxEventGroupNumber;
 	#endif
 
+	#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+		uint8_t ucStaticallyAllocated; /*< Set to pdTRUE if the event group memory was provided by the application so it is not freed when the event group is deleted. */
+	#endif
+
 } EventGroup_t;
 
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+	/* StaticEventGroup_t is reserved by the application in place of an
+	EventGroup_t, so the two must be the same size.  The array size is negative
+	if they are not. */
+	typedef char StaticEventGroupSizeCheck_t[ ( sizeof( StaticEventGroup_t ) == sizeof( EventGroup_t ) ) ? 1 : -1 ];
+#endif
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -140,6 +151,13 @@ EventGroup_t *pxEventBits;
 	{
 		pxEventBits->uxEventBits = 0;
 		vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+
+		#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+		{
+			pxEventBits->ucStaticallyAllocated = pdFALSE;
+		}
+		#endif
+
 		traceEVENT_GROUP_CREATE( pxEventBits );
 	}
 	else
@@ -151,6 +169,32 @@ EventGroup_t *pxEventBits;
 }
 /*-----------------------------------------------------------*/
 
+#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	EventGroupHandle_t xEventGroupCreateStatic( StaticEventGroup_t *pxEventGroupBuffer )
+	{
+	EventGroup_t *pxEventBits = ( EventGroup_t * ) pxEventGroupBuffer; /*lint !e740 StaticEventGroup_t has the same size as EventGroup_t, checked above. */
+
+		configASSERT( pxEventGroupBuffer );
+
+		if( pxEventBits != NULL )
+		{
+			pxEventBits->uxEventBits = 0;
+			vListInitialise( &( pxEventBits->xTasksWaitingForBits ) );
+			pxEventBits->ucStaticallyAllocated = pdTRUE;
+			traceEVENT_GROUP_CREATE( pxEventBits );
+		}
+		else
+		{
+			traceEVENT_GROUP_CREATE_FAILED();
+		}
+
+		return ( EventGroupHandle_t ) pxEventBits;
+	}
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
 EventBits_t xEventGroupSync( EventGroupHandle_t xEventGroup, const EventBits_t uxBitsToSet, const EventBits_t uxBitsToWaitFor, TickType_t xTicksToWait )
 {
 EventBits_t uxOriginalBitValue, uxReturn;
@@ -581,7 +625,18 @@ const List_t *pxTasksWaitingForBits = &( pxEventBits->xTasksWaitingForBits );
 			( void ) xTaskRemoveFromUnorderedEventList( pxTasksWaitingForBits->xListEnd.pxNext, eventUNBLOCKED_DUE_TO_BIT_SET );
 		}
 
-		vPortFree( pxEventBits );
+		#if( configSUPPORT_STATIC_ALLOCATION == 1 )
+		if( pxEventBits->ucStaticallyAllocated != pdFALSE )
+		{
+			/* The memory belongs to the application, there is nothing to
+			free. */
+			mtCOVERAGE_TEST_MARKER();
+		}
+		else
+		#endif
+		{
+			vPortFree( pxEventBits );
+		}
 	}
 	( void ) xTaskResumeAll();
 }
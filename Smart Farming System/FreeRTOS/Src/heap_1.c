@@ -83,6 +83,8 @@ task.h is included from an application file. */
 
 #undef MPU_WRAPPERS_INCLUDED_FROM_API_FILE
 
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+
 /* A few bytes might be lost to byte aligning the heap start address. */
 #define configADJUSTED_HEAP_SIZE	( configTOTAL_HEAP_SIZE - portBYTE_ALIGNMENT )
 
@@ -90,11 +92,15 @@ task.h is included from an application file. */
 static uint8_t ucHeap[ configTOTAL_HEAP_SIZE ];
 static size_t xNextFreeByte = ( size_t ) 0;
 
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+
 /*-----------------------------------------------------------*/
 
 void *pvPortMalloc( size_t xWantedSize )
 {
 void *pvReturn = NULL;
+
+#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
 static uint8_t *pucAlignedHeap = NULL;
 
 	/* Ensure that blocks are always aligned to the required number of bytes. */
@@ -127,6 +133,12 @@ static uint8_t *pucAlignedHeap = NULL;
 		traceMALLOC( pvReturn, xWantedSize );
 	}
 	( void ) xTaskResumeAll();
+#else
+	/* Every kernel object is placed by the linker, there is no heap to take
+	memory from. */
+	( void ) xWantedSize;
+	traceMALLOC( pvReturn, xWantedSize );
+#endif /* configSUPPORT_DYNAMIC_ALLOCATION */
 
 	#if( configUSE_MALLOC_FAILED_HOOK == 1 )
 	{
@@ -157,13 +169,25 @@ void vPortFree( void *pv )
 void vPortInitialiseBlocks( void )
 {
 	/* Only required when static memory is not cleared. */
-	xNextFreeByte = ( size_t ) 0;
+	#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	{
+		xNextFreeByte = ( size_t ) 0;
+	}
+	#endif
 }
 /*-----------------------------------------------------------*/
 
 size_t xPortGetFreeHeapSize( void )
 {
-	return ( configADJUSTED_HEAP_SIZE - xNextFreeByte );
+	#if( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+	{
+		return ( configADJUSTED_HEAP_SIZE - xNextFreeByte );
+	}
+	#else
+	{
+		return ( size_t ) 0;
+	}
+	#endif
 }
 
 
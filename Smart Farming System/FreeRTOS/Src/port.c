@@ -74,6 +74,7 @@ Changes from V2.6.0
 
 #include <stdlib.h>
 #include <avr/interrupt.h>
+#include <avr/sleep.h>
 
 #include "FreeRTOS.h"
 #include "task.h"
@@ -88,9 +89,20 @@ Changes from V2.6.0
 /* Hardware constants for timer 1. */
 #define portCLEAR_COUNTER_ON_MATCH				( ( uint8_t ) 0x08 )
 #define portPRESCALE_64							( ( uint8_t ) 0x03 )
-#define portCLOCK_PRESCALER						( ( uint32_t ) 64 )
 #define portCOMPARE_MATCH_A_INTERRUPT_ENABLE	( ( uint8_t ) 0x10 )
 
+/* Idle mode sleep of the tickless idle, the timer keeps counting.  The
+instruction after sei is always executed before a pending interrupt, so no
+interrupt can be lost between the two. */
+#define portTIMER_SLEEP()												\
+{																		\
+	set_sleep_mode( SLEEP_MODE_IDLE );									\
+	sleep_enable();														\
+	asm volatile ( "sei		\n\t"										\
+				   "sleep	\n\t" ::: "memory" );						\
+	sleep_disable();													\
+}
+
 /*-----------------------------------------------------------*/
 
 /* We require the address of the pxCurrentTCB variable, but don't want to know
@@ -98,6 +110,46 @@ any details of its type. */
 typedef void TCB_t;
 extern volatile TCB_t * volatile pxCurrentTCB;
 
+/* The timer 1 tick, the tickless idle and the run time counter. */
+#include "porttimer.h"
+
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+
+/* Bit of each priority in the ready priorities bit map.  Reading it from flash
+is faster than a shift by a variable amount, which the AVR does one bit at a
+time. */
+const uint8_t ucPortPriorityBit[ 8 ] PROGMEM =
+{
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80
+};
+
+/* Index of the highest set bit of each 8 bit value, so the highest priority
+with a ready task is found with a single lookup whatever the number of
+priorities.  Entry 0 is never used as the idle task is always ready. */
+const uint8_t ucPortHighestBit[ 256 ] PROGMEM =
+{
+	0, 0, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3,
+	4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+	5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+	5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5, 5,
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+	6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7,
+	7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7, 7
+};
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+
 /*-----------------------------------------------------------*/
 
 /* 
@@ -384,6 +436,7 @@ void vPortYieldFromTick( void ) __attribute__ ( ( naked ) );
 void vPortYieldFromTick( void )
 {
 	portSAVE_CONTEXT();
+	prvTimerPeriodEnded();
 	if( xTaskIncrementTick() != pdFALSE )
 	{
 		vTaskSwitchContext();
@@ -438,9 +491,11 @@ uint8_t ucHighByte, ucLowByte;
 	/*
 	 * Tick ISR for preemptive scheduler.  We can use a naked attribute as
 	 * the context is saved at the start of vPortYieldFromTick().  The tick
-	 * count is incremented after the context is saved.
+	 * count is incremented after the context is saved.  Only the vector table
+	 * refers to it, used and externally_visible keep it in a -flto build as
+	 * the ISR() macro of avr-libc does.
 	 */
-	void TIMER1_COMPA_vect( void ) __attribute__ ( ( signal, naked ) );
+	void TIMER1_COMPA_vect( void ) __attribute__ ( ( signal, naked, used, externally_visible ) );
 	void TIMER1_COMPA_vect( void )
 	{
 		vPortYieldFromTick();
@@ -453,9 +508,10 @@ uint8_t ucHighByte, ucLowByte;
 	 * tick count.  We don't need to switch context, this can only be done by
 	 * manual calls to taskYIELD();
 	 */
-	void TIMER1_COMPA_vect( void ) __attribute__ ( ( signal ) );
+	void TIMER1_COMPA_vect( void ) __attribute__ ( ( signal, used, externally_visible ) );
 	void TIMER1_COMPA_vect( void )
 	{
+		prvTimerPeriodEnded();
 		xTaskIncrementTick();
 	}
 #endif
@@ -0,0 +1,209 @@
+/*
+ * Timer 1 tick, tickless idle and run time counter of the ATmega32 port.
+ *
+ * Included by port.c.  Only the timer registers (TCNT1, OCR1A, TIFR), the
+ * interrupt macros and portTIMER_SLEEP() are used, so the host test
+ * (test/test_tickless.c) builds the same code over a model of the timer.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef PORTTIMER_H
+#define PORTTIMER_H
+
+/* Hardware constants for timer 1. */
+#define portCLOCK_PRESCALER						( ( uint32_t ) 64 )
+#define portCOMPARE_MATCH_A_FLAG				( ( uint8_t ) 0x10 )
+
+/* Timer 1 counts in one tick, and the longest time the tick can be suppressed
+for with a 16 bit compare register. */
+#define portCOUNTS_PER_TICK						( ( uint16_t ) ( configCPU_CLOCK_HZ / configTICK_RATE_HZ / portCLOCK_PRESCALER ) )
+#define portMAX_SUPPRESSED_TICKS				( ( TickType_t ) ( 0xffffUL / portCOUNTS_PER_TICK ) )
+
+/*-----------------------------------------------------------*/
+
+#if configUSE_TICKLESS_IDLE == 1
+
+	/* Set by the tick interrupt, tells vPortSuppressTicksAndSleep() whether
+	the sleep was ended by the compare match or by another interrupt. */
+	static volatile uint8_t ucTickInterruptFired = 0;
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+#if configGENERATE_RUN_TIME_STATS == 1
+
+	/* Timer 1 counts of all the compare periods completed so far.  The counter
+	is cleared at each compare match, so the run time is this plus TCNT1. */
+	static volatile uint32_t ulRunTimeBase = 0;
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Called by the tick interrupt before the tick count is incremented.  The
+ * counter was cleared by the match that ended this period, which is one tick,
+ * or several when the tick was suppressed.
+ */
+static void prvTimerPeriodEnded( void )
+{
+	#if configGENERATE_RUN_TIME_STATS == 1
+	{
+		ulRunTimeBase += ( uint32_t ) OCR1A + 1;
+	}
+	#endif /* configGENERATE_RUN_TIME_STATS */
+	#if configUSE_TICKLESS_IDLE == 1
+	{
+		/* The compare value may have been stretched to cover several ticks,
+		the counter has just been cleared so the normal period can be set
+		back. */
+		OCR1A = portCOUNTS_PER_TICK - 1;
+		ucTickInterruptFired = pdTRUE;
+	}
+	#endif /* configUSE_TICKLESS_IDLE */
+}
+/*-----------------------------------------------------------*/
+
+#if configUSE_TICKLESS_IDLE == 1
+
+	/*
+	 * Called by the idle task, with the scheduler suspended, when no task
+	 * needs to run for at least xExpectedIdleTime ticks.  Timer 1 keeps
+	 * counting from the last tick, so the compare value is moved to the end of
+	 * the idle time and the CPU sleeps with portTIMER_SLEEP(), which enables
+	 * the interrupts.  On wake up the ticks that passed are added with
+	 * vTaskStepTick().  The counter is never written unless a compare was
+	 * missed, so no timer counts are lost and the tick count stays exact.
+	 */
+	void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+	{
+	uint16_t usCount;
+	uint16_t usCompare;
+	TickType_t xCompleteTicks;
+	TickType_t xModifiableIdleTime;
+
+		if( xExpectedIdleTime > portMAX_SUPPRESSED_TICKS )
+		{
+			xExpectedIdleTime = portMAX_SUPPRESSED_TICKS;
+		}
+
+		portDISABLE_INTERRUPTS();
+
+		/* Don't sleep if a task was readied or a yield was pended. */
+		if( eTaskConfirmSleepModeStatus() == eAbortSleep )
+		{
+			portENABLE_INTERRUPTS();
+			return;
+		}
+
+		/* The counter was cleared at the last tick, so this is the count at the
+		end of the expected idle time.  xExpectedIdleTime is at least 2 so the
+		counter has not passed it yet. */
+		OCR1A = ( uint16_t ) ( ( xExpectedIdleTime * portCOUNTS_PER_TICK ) - 1 );
+
+		/* Don't sleep if a tick is waiting to be processed, including one that
+		ended just before the compare value was moved.  The tick interrupt
+		counts the compare value as the length of the period, so the normal
+		one is set back first. */
+		if( ( TIFR & portCOMPARE_MATCH_A_FLAG ) != 0 )
+		{
+			OCR1A = portCOUNTS_PER_TICK - 1;
+			portENABLE_INTERRUPTS();
+			return;
+		}
+
+		ucTickInterruptFired = pdFALSE;
+
+		/* The pre sleep processing may cancel the sleep by clearing its copy,
+		the compare value set above stays the end of the idle time. */
+		xModifiableIdleTime = xExpectedIdleTime;
+		configPRE_SLEEP_PROCESSING( xModifiableIdleTime );
+		if( xModifiableIdleTime > 0 )
+		{
+			portTIMER_SLEEP();
+			portDISABLE_INTERRUPTS();
+		}
+		configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+		/* Read the counter before looking at the compare flag, a count read
+		with the flag still clear is from before the match. */
+		usCount = TCNT1;
+
+		if( ( ucTickInterruptFired != pdFALSE ) || ( ( TIFR & portCOMPARE_MATCH_A_FLAG ) != 0 ) )
+		{
+			/* The compare match ended the sleep, the whole idle time passed.
+			The tick interrupt counts (or is about to count) the last tick and
+			sets the normal period again.  The compare value is left for it as
+			it is also the length of the period for the run time counter. */
+			vTaskStepTick( xExpectedIdleTime - 1 );
+		}
+		else
+		{
+			/* Another interrupt ended the sleep.  Step the whole ticks that
+			passed and let the compare match end the current tick. */
+			xCompleteTicks = usCount / portCOUNTS_PER_TICK;
+			usCompare = ( uint16_t ) ( ( ( xCompleteTicks + 1 ) * portCOUNTS_PER_TICK ) - 1 );
+			OCR1A = usCompare;
+
+			if( TCNT1 > usCompare )
+			{
+				/* The counter passed the new compare value while it was being
+				calculated, so the match was missed.  Count the tick here and
+				move the counter back one tick period, this is the only case
+				where a few timer counts can be lost. */
+				TCNT1 -= ( uint16_t ) ( ( xCompleteTicks + 1 ) * portCOUNTS_PER_TICK );
+				OCR1A = portCOUNTS_PER_TICK - 1;
+				xCompleteTicks++;
+
+				#if configGENERATE_RUN_TIME_STATS == 1
+				{
+					ulRunTimeBase += ( uint32_t ) xCompleteTicks * portCOUNTS_PER_TICK;
+				}
+				#endif /* configGENERATE_RUN_TIME_STATS */
+			}
+
+			vTaskStepTick( xCompleteTicks );
+		}
+
+		portENABLE_INTERRUPTS();
+	}
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
+
+#if configGENERATE_RUN_TIME_STATS == 1
+
+	/*
+	 * Run time counter for the task statistics, in timer 1 counts (8 us at
+	 * 8 MHz).  Reading TCNT1 between the ticks gives a resolution well below
+	 * the tick period for the short slices of the application tasks.  The
+	 * counter wraps after about 9.5 hours.
+	 */
+	uint32_t ulPortGetRunTimeCounter( void )
+	{
+	uint32_t ulCount;
+	uint16_t usCount;
+
+		portENTER_CRITICAL();
+		{
+			usCount = TCNT1;
+			ulCount = ulRunTimeBase;
+
+			if( ( TIFR & portCOMPARE_MATCH_A_FLAG ) != 0 )
+			{
+				/* The counter was cleared but the tick interrupt has not run
+				yet (interrupts are off, e.g. when called from the context
+				switch).  Count the period that ended and read the counter again
+				as the first read may be from before the match. */
+				ulCount += ( uint32_t ) OCR1A + 1;
+				usCount = TCNT1;
+			}
+		}
+		portEXIT_CRITICAL();
+
+		return ulCount + usCount;
+	}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+
+#endif /* PORTTIMER_H */
@@ -153,12 +153,23 @@ typedef struct QueueDefinition
 		struct QueueDefinition *pxQueueSetContainer;
 	#endif
 
+	#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+		uint8_t ucStaticallyAllocated;	/*< Set to pdTRUE if the queue memory was provided by the application so it is not freed when the queue is deleted. */
+	#endif
+
 } xQUEUE;
 
 /* The old xQUEUE name is maintained above then typedefed to the new Queue_t
 name below to enable the use of older kernel aware debuggers. */
 typedef xQUEUE Queue_t;
 
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+	/* StaticQueue_t is reserved by the application in place of a Queue_t, so
+	the two must be the same size.  The array size is negative if they are
+	not. */
+	typedef char StaticQueueSizeCheck_t[ ( sizeof( StaticQueue_t ) == sizeof( Queue_t ) ) ? 1 : -1 ];
+#endif
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -198,6 +209,12 @@ typedef xQUEUE Queue_t;
  */
 static void prvUnlockQueue( Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 
+/*
+ * Called by xQueueGenericCreate() and xQueueGenericCreateStatic() once the
+ * queue structure and its storage area are in place.
+ */
+static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, const uint8_t ucQueueType, Queue_t *pxNewQueue ) PRIVILEGED_FUNCTION;
+
 /*
  * Uses a critical section to determine if there is any data in a queue.
  *
@@ -328,25 +345,13 @@ QueueHandle_t xReturn = NULL;
 			pxNewQueue->pcHead = ( int8_t * ) pvPortMalloc( xQueueSizeInBytes );
 			if( pxNewQueue->pcHead != NULL )
 			{
-				/* Initialise the queue members as described above where the
-				queue type is defined. */
-				pxNewQueue->uxLength = uxQueueLength;
-				pxNewQueue->uxItemSize = uxItemSize;
-				( void ) xQueueGenericReset( pxNewQueue, pdTRUE );
-
-				#if ( configUSE_TRACE_FACILITY == 1 )
+				#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
 				{
-					pxNewQueue->ucQueueType = ucQueueType;
+					pxNewQueue->ucStaticallyAllocated = pdFALSE;
 				}
-				#endif /* configUSE_TRACE_FACILITY */
+				#endif /* configSUPPORT_STATIC_ALLOCATION */
 
-				#if( configUSE_QUEUE_SETS == 1 )
-				{
-					pxNewQueue->pxQueueSetContainer = NULL;
-				}
-				#endif /* configUSE_QUEUE_SETS */
-
-				traceQUEUE_CREATE( pxNewQueue );
+				prvInitialiseNewQueue( uxQueueLength, uxItemSize, ucQueueType, pxNewQueue );
 				xReturn = pxNewQueue;
 			}
 			else
@@ -371,6 +376,81 @@ QueueHandle_t xReturn = NULL;
 }
 /*-----------------------------------------------------------*/
 
+#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+
+	QueueHandle_t xQueueGenericCreateStatic( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, uint8_t *pucQueueStorage, StaticQueue_t *pxStaticQueue, const uint8_t ucQueueType )
+	{
+	Queue_t *pxNewQueue = NULL;
+
+		configASSERT( uxQueueLength > ( UBaseType_t ) 0 );
+		configASSERT( pxStaticQueue != NULL );
+
+		/* A storage area is needed if, and only if, items are copied. */
+		configASSERT( !( ( pucQueueStorage != NULL ) && ( uxItemSize == 0 ) ) );
+		configASSERT( !( ( pucQueueStorage == NULL ) && ( uxItemSize != 0 ) ) );
+
+		if( ( uxQueueLength > ( UBaseType_t ) 0 ) && ( pxStaticQueue != NULL ) && ( ( pucQueueStorage != NULL ) || ( uxItemSize == ( UBaseType_t ) 0 ) ) )
+		{
+			pxNewQueue = ( Queue_t * ) pxStaticQueue; /*lint !e740 StaticQueue_t has the same size as Queue_t, checked above. */
+			pxNewQueue->ucStaticallyAllocated = pdTRUE;
+
+			if( uxItemSize == ( UBaseType_t ) 0 )
+			{
+				/* Nothing is copied so there is no storage area, but a NULL
+				pcHead would mark the queue as a mutex.  Point it at the
+				queue structure itself, which is never dereferenced through
+				pcHead when the item size is zero. */
+				pxNewQueue->pcHead = ( int8_t * ) pxNewQueue;
+			}
+			else
+			{
+				/* The storage area is uxQueueLength * uxItemSize bytes, the
+				extra byte of the heap version is only a marker and is never
+				written. */
+				pxNewQueue->pcHead = ( int8_t * ) pucQueueStorage;
+			}
+
+			prvInitialiseNewQueue( uxQueueLength, uxItemSize, ucQueueType, pxNewQueue );
+		}
+		else
+		{
+			traceQUEUE_CREATE_FAILED( ucQueueType );
+		}
+
+		return pxNewQueue;
+	}
+
+#endif /* configSUPPORT_STATIC_ALLOCATION */
+/*-----------------------------------------------------------*/
+
+static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength, const UBaseType_t uxItemSize, const uint8_t ucQueueType, Queue_t *pxNewQueue )
+{
+	/* Remove compiler warnings about unused parameters should
+	configUSE_TRACE_FACILITY not be set to 1. */
+	( void ) ucQueueType;
+
+	/* Initialise the queue members as described above where the
+	queue type is defined. */
+	pxNewQueue->uxLength = uxQueueLength;
+	pxNewQueue->uxItemSize = uxItemSize;
+	( void ) xQueueGenericReset( pxNewQueue, pdTRUE );
+
+	#if ( configUSE_TRACE_FACILITY == 1 )
+	{
+		pxNewQueue->ucQueueType = ucQueueType;
+	}
+	#endif /* configUSE_TRACE_FACILITY */
+
+	#if( configUSE_QUEUE_SETS == 1 )
+	{
+		pxNewQueue->pxQueueSetContainer = NULL;
+	}
+	#endif /* configUSE_QUEUE_SETS */
+
+	traceQUEUE_CREATE( pxNewQueue );
+}
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_MUTEXES == 1 )
 
 	QueueHandle_t xQueueCreateMutex( const uint8_t ucQueueType )
@@ -415,6 +495,12 @@ QueueHandle_t xReturn = NULL;
 			}
 			#endif
 
+			#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+			{
+				pxNewQueue->ucStaticallyAllocated = pdFALSE;
+			}
+			#endif
+
 			/* Ensure the event queues start with the correct state. */
 			vListInitialise( &( pxNewQueue->xTasksWaitingToSend ) );
 			vListInitialise( &( pxNewQueue->xTasksWaitingToReceive ) );
@@ -1581,11 +1667,23 @@ Queue_t * const pxQueue = ( Queue_t * ) xQueue;
 		vQueueUnregisterQueue( pxQueue );
 	}
 	#endif
-	if( pxQueue->pcHead != NULL )
+
+	#if ( configSUPPORT_STATIC_ALLOCATION == 1 )
+	if( pxQueue->ucStaticallyAllocated != pdFALSE )
 	{
-		vPortFree( pxQueue->pcHead );
+		/* The memory belongs to the application, there is nothing to
+		free. */
+		mtCOVERAGE_TEST_MARKER();
+	}
+	else
+	#endif /* configSUPPORT_STATIC_ALLOCATION */
+	{
+		if( pxQueue->pcHead != NULL )
+		{
+			vPortFree( pxQueue->pcHead );
+		}
+		vPortFree( pxQueue );
 	}
-	vPortFree( pxQueue );
 }
 /*-----------------------------------------------------------*/
 
@@ -0,0 +1,32 @@
+# Toolchain file of the ATmega32 firmware, given to cmake with
+#     cmake -S . -B build-avr -DCMAKE_TOOLCHAIN_FILE=cmake/avr-gcc.cmake
+# avr-gcc is taken from the PATH, or from AVR_TOOLCHAIN_DIR (the directory
+# holding bin/avr-gcc, e.g. the toolchain shipped with Atmel Studio).
+
+set(CMAKE_SYSTEM_NAME Generic)
+set(CMAKE_SYSTEM_PROCESSOR avr)
+
+set(AVR_TOOLCHAIN_DIR "$ENV{AVR_TOOLCHAIN_DIR}" CACHE PATH "directory holding bin/avr-gcc")
+set(AVR_MCU atmega32 CACHE STRING "device given to -mmcu")
+set(AVR_F_CPU 8000000UL CACHE STRING "CPU clock in Hz")
+
+if(AVR_TOOLCHAIN_DIR)
+	set(AVR_SEARCH_PATH HINTS "${AVR_TOOLCHAIN_DIR}/bin")
+endif()
+
+find_program(CMAKE_C_COMPILER avr-gcc ${AVR_SEARCH_PATH} REQUIRED)
+find_program(CMAKE_AR avr-gcc-ar ${AVR_SEARCH_PATH} REQUIRED)
+find_program(CMAKE_RANLIB avr-gcc-ranlib ${AVR_SEARCH_PATH} REQUIRED)
+find_program(CMAKE_OBJCOPY avr-objcopy ${AVR_SEARCH_PATH} REQUIRED)
+find_program(CMAKE_OBJDUMP avr-objdump ${AVR_SEARCH_PATH} REQUIRED)
+find_program(CMAKE_SIZE avr-size ${AVR_SEARCH_PATH})
+
+set(CMAKE_C_FLAGS_INIT "-mmcu=${AVR_MCU} -DF_CPU=${AVR_F_CPU}")
+set(CMAKE_EXE_LINKER_FLAGS_INIT "-mmcu=${AVR_MCU}")
+
+# the compiler checks can not link a program without the startup files of the device
+set(CMAKE_TRY_COMPILE_TARGET_TYPE STATIC_LIBRARY)
+
+set(CMAKE_FIND_ROOT_PATH_MODE_PROGRAM NEVER)
+set(CMAKE_FIND_ROOT_PATH_MODE_LIBRARY ONLY)
+set(CMAKE_FIND_ROOT_PATH_MODE_INCLUDE ONLY)
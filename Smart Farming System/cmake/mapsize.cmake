@@ -0,0 +1,159 @@
+# Per symbol flash and RAM use of the firmware, read from the GNU ld map file.
+#
+#     cmake -DMAP=sfs.map [-DTOP=40] [-DFLASH_SIZE=32768 -DRAM_SIZE=2048 -DEEPROM_SIZE=1024] -P mapsize.cmake
+#
+# Each input section with a size is one line, named after the function or the
+# variable when it was compiled with -ffunction-sections -fdata-sections (the
+# section is .text.<name>) or after its object file otherwise.  The region is
+# the one of the output section holding it:
+#     flash   .text (code and PROGMEM data)
+#     data    .data (initialized variables and constants, in RAM with a copy in flash)
+#     ram     .bss and .noinit
+#     eeprom  .eeprom
+# The lines are sorted by size, TOP limits their number (0 for all).
+
+if(NOT MAP)
+	message(FATAL_ERROR "give the map file with -DMAP=<file>")
+endif()
+if(NOT DEFINED TOP)
+	set(TOP 0)
+endif()
+
+file(READ "${MAP}" text)
+
+# only the memory map, brackets and semicolons would break the list of lines
+string(FIND "${text}" "Linker script and memory map" start)
+if(start LESS 0)
+	message(FATAL_ERROR "${MAP} is not a GNU ld map file")
+endif()
+string(SUBSTRING "${text}" ${start} -1 text)
+string(REPLACE ";" "," text "${text}")
+string(REPLACE "[" "(" text "${text}")
+string(REPLACE "]" ")" text "${text}")
+string(REPLACE "\n" ";" lines "${text}")
+
+set(region "")
+set(pending "")
+set(names "")
+foreach(line IN LISTS lines)
+	set(section "")
+
+	if(line MATCHES "^(\\.[^ ]+)")
+		# output section, the ones not loaded to the device are skipped
+		set(output "${CMAKE_MATCH_1}")
+		if(output MATCHES "^\\.text$")
+			set(region flash)
+		elseif(output MATCHES "^\\.data$")
+			set(region data)
+		elseif(output MATCHES "^\\.(bss|noinit)$")
+			set(region ram)
+		elseif(output MATCHES "^\\.eeprom$")
+			set(region eeprom)
+		else()
+			set(region "")
+		endif()
+		set(pending "")
+	elseif(region STREQUAL "")
+	elseif(line MATCHES "^ ([.A-Za-z_][^ ]*|COMMON) +0x([0-9a-fA-F]+) +0x([0-9a-fA-F]+) +(.+)$")
+		set(section "${CMAKE_MATCH_1}")
+		set(size "0x${CMAKE_MATCH_3}")
+		set(file "${CMAKE_MATCH_4}")
+	elseif(line MATCHES "^ ([.A-Za-z_][^ ]*|COMMON)$")
+		# a long section name, the address and the size are on the next line
+		set(pending "${CMAKE_MATCH_1}")
+	elseif(NOT pending STREQUAL "" AND line MATCHES "^ +0x([0-9a-fA-F]+) +0x([0-9a-fA-F]+) +(.+)$")
+		set(section "${pending}")
+		set(size "0x${CMAKE_MATCH_2}")
+		set(file "${CMAKE_MATCH_3}")
+		set(pending "")
+	else()
+		set(pending "")
+	endif()
+
+	if(NOT section STREQUAL "")
+		math(EXPR size "${size}")
+		if(size GREATER 0)
+			if(section MATCHES "^\\.(text|data|bss|rodata|noinit|progmem\\.data|progmem\\.gcc_sw_table|progmem)\\.(.+)$")
+				set(name "${CMAKE_MATCH_2}")
+			else()
+				get_filename_component(file "${file}" NAME)
+				set(name "${file}(${section})")
+			endif()
+
+			# the same name may come from several sections, e.g. .text of a library
+			set(key "${region} ${name}")
+			if(DEFINED "SIZE_${key}")
+				math(EXPR "SIZE_${key}" "${SIZE_${key}} + ${size}")
+			else()
+				set("SIZE_${key}" ${size})
+				list(APPEND names "${key}")
+			endif()
+
+			if(DEFINED "TOTAL_${region}")
+				math(EXPR "TOTAL_${region}" "${TOTAL_${region}} + ${size}")
+			else()
+				set("TOTAL_${region}" ${size})
+			endif()
+		endif()
+	endif()
+endforeach()
+
+# zero padded sizes first so the string sort is a size sort
+set(rows "")
+foreach(key IN LISTS names)
+	string(LENGTH "${SIZE_${key}}" length)
+	math(EXPR length "10 - ${length}")
+	string(REPEAT "0" ${length} pad)
+	list(APPEND rows "${pad}${SIZE_${key}} ${key}")
+endforeach()
+list(SORT rows ORDER DESCENDING)
+if(TOP GREATER 0)
+	list(LENGTH rows count)
+	if(count GREATER TOP)
+		list(SUBLIST rows 0 ${TOP} rows)
+	endif()
+endif()
+
+# one line of the report, the size right aligned
+function(print_row size region name)
+	string(LENGTH "${size}" length)
+	math(EXPR length "8 - ${length}")
+	if(length GREATER 0)
+		string(REPEAT " " ${length} pad)
+	endif()
+	string(LENGTH "${region}" length)
+	math(EXPR length "8 - ${length}")
+	string(REPEAT " " ${length} gap)
+	message("${pad}${size}  ${region}${gap}${name}")
+endfunction()
+
+message("   bytes  region  symbol")
+foreach(row IN LISTS rows)
+	string(REGEX MATCH "^0*([0-9]+) ([a-z]+) (.+)$" row "${row}")
+	print_row("${CMAKE_MATCH_1}" "${CMAKE_MATCH_2}" "${CMAKE_MATCH_3}")
+endforeach()
+
+# totals of the device memories, flash holds the copy of .data too
+foreach(region flash data ram eeprom)
+	if(NOT DEFINED "TOTAL_${region}")
+		set("TOTAL_${region}" 0)
+	endif()
+endforeach()
+math(EXPR flash "${TOTAL_flash} + ${TOTAL_data}")
+math(EXPR ram "${TOTAL_data} + ${TOTAL_ram}")
+
+function(print_total memory used capacity)
+	if(capacity)
+		math(EXPR percent "(${used} * 1000) / ${capacity}")
+		math(EXPR whole "${percent} / 10")
+		math(EXPR tenth "${percent} % 10")
+		message("${memory} ${used} of ${capacity} bytes (${whole}.${tenth}%)")
+	else()
+		message("${memory} ${used} bytes")
+	endif()
+endfunction()
+
+message("")
+print_total("flash: " ${flash} "${FLASH_SIZE}")
+print_total("ram:   " ${ram} "${RAM_SIZE}")
+print_total("eeprom:" ${TOTAL_eeprom} "${EEPROM_SIZE}")
@@ -23,12 +23,20 @@
 #include "micro_config.h"
 #include "std_types.h"
 #include "common_macros.h"
+#include "format.h"
 #include "stdlib.h"
 #include "string.h"
 #include "uart.h"
 #include "lcd.h"
 #include "adc.h"
 #include "sensors.h"
+#include "calibration.h"
+#include "control.h"
+#include "stackmon.h"
+#include "datamodel.h"
+#include "screen.h"
+#include "trend.h"
+#include "trace.h"
 
 /* Tasks /Functions Prototypes*/
 void System_Init(void);
@@ -37,113 +45,44 @@ void T_SysCheck(void* pvParam);
 void T_Terminal(void* pvParam);
 void T_Sensing(void* pvParam);
 void T_Display(void* pvParam);
-
-/* used to trigger the T_Control task */
+void vApplicationIdleHook(void);
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char * pcTaskName);
+void vApplicationGetIdleTaskMemory(StaticTask_t ** ppxIdleTaskTCBBuffer, StackType_t ** ppxIdleTaskStackBuffer, uint16_t * pusIdleTaskStackSize);
+void Sensors_ScanDone(void);
+void Actuators_DataChanged(DataModel_Fields_t changed);
+void SysCheck_DataChanged(DataModel_Fields_t changed);
+void Display_DataChanged(DataModel_Fields_t changed);
+void Terminal_Calibration(void);
+void Terminal_Tuning(void);
+void Terminal_RunStats(void);
+void Terminal_LcdStats(void);
+
+/* tasks stack sizes (bytes), the stacks are static arrays so the linker
+ * places them and the RAM they use shows in the .bss size, the 'S' terminal
+ * command reports the use of each one and a recommended size */
+#define T_DISPLAY_STACK			200
+#define T_SENSING_STACK			100
+#define T_TERMINAL_STACK		180
+#define T_SYSCHECK_STACK		120
+#define T_CONTROL_STACK			100
+#define T_IDLE_STACK			configMINIMAL_STACK_SIZE
+
+/* actuators bits of the T_Control notification value */
 #define E_PUMP			(1<<0)		
 #define E_HEATER		(1<<1)		
 #define E_COOLER		(1<<2)		
-#define E_CONTROLMASK 	(0b111)
 
-/* used to trigger the T_Display task */
-#define E_MainScreen	(1<<0)
-#define E_ConfigScreen	(1<<1)
-#define E_HUpdated		(1<<2)
-#define E_TUpdated		(1<<3)
-#define E_TTUpdated		(1<<4)	
-#define E_HTUpdated		(1<<5)
-#define E_MotorState	(1<<6) 	
-#define E_Next			(1<<7)	
-#define E_DISPLAYMASK 	(0b11111111)
+/* notification bits of the T_Display task, above the DM_ bits of the
+ * changed data model fields */
+#define E_Next			(1<<8)	
+#define E_DISPLAYMASK 	(0x1FF)
+
+/* max ticks between two bytes of a binary terminal frame */
+#define TERMINAL_FRAME_TIMEOUT	100
 
 /* Motores connections */
 #define WATER_PUMP 		PIN2
 #define HEATER	   		PIN3
 #define COOLER	   		PIN4
 
-/******************* Display ************************/
-#define LCD_MAIN_SCREEN_L1		"T =    C    H =    %"
-#define LCD_MAIN_SCREEN_L2		"TT=    C    TH=    %"
-#define LCD_TEMP_COL			4
-#define LCD_HUMI_COL			16
-
-#define LCD_MAIN_SCREEN_L3		"H:      C:     P:   "
-#define LCD_HEATER_COL			2
-#define LCD_COOLER_COL			10
-#define LCD_PUMP_COL			17
-
-#define LCD_MAIN_SCREEN_L4		"  Configuration: C  "
-
-#define LCD_CONFIG_SCREEN_L1	"TempThreshold:     C"
-#define LCD_CONFIG_SCREEN_L2	"HumiThreshold:     %"
-#define LCD_CONFIG_COL			14
-
-#define LCD_CONFIG_SCREEN_L4	"OK:O Next:N Cancel:C"
-
-EventGroupHandle_t egControl = NULL;
-EventGroupHandle_t egDisplay = NULL;
-
-EventBits_t ebControlBits;
-EventBits_t ebDisplayBits;
-SemaphoreHandle_t bsCheck;
-
-/**
- * @brief Motor State enum
- * 
- */
-typedef enum
-{
-	OFF,ON
-}Motor;
-
-/**
- * @brief System Motors
- * 
- */
-struct
-{
-	Motor Water_Pump;
-	Motor Heater;
-	Motor Cooler;
-}Motors_State;
-
-/**
- * @brief System States enum
- * 
- */
-typedef enum {MainState, ConfigState} SystemState_t ;
-
-
-/**
- * @brief All system data
- * 
- */
-struct
-{
-	/* system state */
-	SystemState_t SystemState;
-
-	/**
-	 * @brief sensors data
-	 * 
-	 */
-	struct
-	{
-		uint8 TempData;
-		uint8 HumiData;
-	} SensorData;
-
-	/**
-	 * @brief threshold values
-	 * 
-	 */
-	struct
-	{
-		uint8 TempT;
-		uint8 HumiT;
-	} SensorThreshold;
-
-} SFS;
-
-
-
 #endif /* APP_H_ */
\ No newline at end of file
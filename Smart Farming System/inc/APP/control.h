@@ -0,0 +1,121 @@
+/**
+ * @file control.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief actuators control engine (on/off with hysteresis or PID) header file
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef CONTROL_H_
+#define CONTROL_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+
+/* actuators index */
+#define CONTROL_COOLER			0
+#define CONTROL_HEATER			1
+#define CONTROL_PUMP			2
+#define CONTROL_ACTUATORS		3
+
+/* control modes */
+#define CONTROL_MODE_ONOFF		0
+#define CONTROL_MODE_PID		1
+
+/* mode of all actuators after reset */
+#define CONTROL_DEFAULT_MODE	CONTROL_MODE_ONOFF
+
+/******************************* on/off mode ********************************/
+/* hysteresis band in sensor units, the actuator turns on when the error goes
+ * above the band and turns off when the error goes back to zero or below */
+#define CONTROL_COOLER_BAND		1
+#define CONTROL_HEATER_BAND		1
+#define CONTROL_PUMP_BAND		2
+
+/* min time in ticks an actuator stays on / off before it may change again,
+ * must be less than 0xffff (16 bit ticks) */
+#define CONTROL_COOLER_MIN_ON	10000
+#define CONTROL_COOLER_MIN_OFF	10000
+#define CONTROL_HEATER_MIN_ON	10000
+#define CONTROL_HEATER_MIN_OFF	10000
+#define CONTROL_PUMP_MIN_ON		5000
+#define CONTROL_PUMP_MIN_OFF	5000
+
+/********************************* PID mode *********************************/
+/* the relays are driven with time proportioned windows: the PID output is the
+ * number of slots the relay is on at the start of each window */
+#define CONTROL_SLOT_TICKS		100
+#define CONTROL_WINDOW_SLOTS	100
+
+/* shorter pulses are dropped and longer ones are stretched to the whole window,
+ * so a relay never switches faster than CONTROL_MIN_SLOTS slots */
+#define CONTROL_MIN_SLOTS		5
+
+/* gains are fixed point with CONTROL_GAIN_BITS fraction bits,
+ * output (slots) = (Kp * e + Ki * sum(e) + Kd * (e - last e)) >> CONTROL_GAIN_BITS
+ * with e in sensor units and sum(e) taken once per window */
+#define CONTROL_GAIN_BITS		4
+
+/* default gains, 10 slots (1 s of 10 s) per unit of error and 1 slot per unit per window */
+#define CONTROL_TEMP_KP			160
+#define CONTROL_TEMP_KI			16
+#define CONTROL_TEMP_KD			0
+#define CONTROL_HUMI_KP			80
+#define CONTROL_HUMI_KI			8
+#define CONTROL_HUMI_KD			0
+
+/**
+ * @brief actuator tuning
+ *
+ */
+typedef struct
+{
+	uint8 Mode;
+	uint16 Kp;
+	uint16 Ki;
+	uint16 Kd;
+} Control_Tuning_t;
+
+/**
+ * @brief start all actuators off in their default mode and gains
+ *
+ */
+void Control_init(void);
+
+/**
+ * @brief decide the state of an actuator, in PID mode it must be called again
+ * before the returned wait runs out to keep the slot timing
+ *
+ * @param actuator actuator index
+ * @param error how far the reading is past the threshold in the direction this
+ * actuator corrects (e.g. Temp - TempT for the cooler)
+ * @param now current tick count
+ * @param pWait lowered to the ticks left until the next change may happen,
+ * left as it is when nothing is pending
+ * @return uint8 1 when the actuator is on, 0 when off
+ */
+uint8 Control_update(uint8 actuator, sint16 error, TickType_t now, TickType_t * pWait);
+
+/**
+ * @brief keep an actuator off (e.g. the heater while the cooler is on), the
+ * next Control_update() turns it off at once, without its min on time, and
+ * after the release it stays off for its min off time in both modes
+ *
+ * @param actuator actuator index
+ * @param locked 1 to keep it off, 0 to release it
+ */
+void Control_interlock(uint8 actuator, uint8 locked);
+
+/**
+ * @brief change the mode and gains of an actuator, the PID restarts from zero
+ *
+ * @param actuator actuator index
+ * @param pTuning new mode and gains
+ * @return ERROR_t E_OK or E_NOK for a wrong actuator index or mode
+ */
+ERROR_t Control_setTuning(uint8 actuator, const Control_Tuning_t * pTuning);
+
+#endif /* CONTROL_H_ */
@@ -0,0 +1,130 @@
+/**
+ * @file datamodel.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief system data shared by the tasks header file
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * the data model owns the sensor readings, the thresholds, the motors state
+ * and the system state, the tasks reach them only through the accessors:
+ * each group has one writer task, a get returns a consistent copy of the
+ * group (see snapshot.h) and a set calls the subscribers of the fields it
+ * changed
+ *
+ */
+
+#ifndef DATAMODEL_H_
+#define DATAMODEL_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+
+/* fields, a mask of them is given to DataModel_subscribe() and to the callbacks */
+#define DM_TEMP			(1<<0)
+#define DM_HUMI			(1<<1)
+#define DM_TEMP_T		(1<<2)
+#define DM_HUMI_T		(1<<3)
+#define DM_PUMP			(1<<4)
+#define DM_HEATER		(1<<5)
+#define DM_COOLER		(1<<6)
+#define DM_STATE		(1<<7)
+
+#define DM_SENSORS		(DM_TEMP | DM_HUMI)
+#define DM_THRESHOLDS	(DM_TEMP_T | DM_HUMI_T)
+#define DM_MOTORS		(DM_PUMP | DM_HEATER | DM_COOLER)
+
+/* max number of subscribers */
+#define DATAMODEL_MAX_SUBSCRIBERS	4
+
+/* values after reset */
+#define DATAMODEL_DEFAULT_TEMP		20
+#define DATAMODEL_DEFAULT_HUMI		30
+#define DATAMODEL_DEFAULT_TEMP_T	20
+#define DATAMODEL_DEFAULT_HUMI_T	30
+
+/**
+ * @brief Motor State enum
+ *
+ */
+typedef enum
+{
+	OFF,ON
+}Motor;
+
+/**
+ * @brief System Motors, written by T_SysCheck
+ *
+ */
+typedef struct
+{
+	Motor Water_Pump;
+	Motor Heater;
+	Motor Cooler;
+} Motors_t;
+
+/**
+ * @brief System States enum, written by T_Terminal
+ *
+ */
+typedef enum {MainState, ConfigState} SystemState_t ;
+
+/**
+ * @brief sensors data, written by T_Sensing
+ *
+ */
+typedef struct
+{
+	uint8 TempData;
+	uint8 HumiData;
+} SensorData_t;
+
+/**
+ * @brief threshold values, written by T_Terminal
+ *
+ */
+typedef struct
+{
+	uint8 TempT;
+	uint8 HumiT;
+} SensorThreshold_t;
+
+/**
+ * @brief mask of DM_ fields
+ *
+ */
+typedef uint8 DataModel_Fields_t;
+
+/**
+ * @brief change callback, runs in the task of the writer right after the
+ * write so it must not block (e.g. it notifies the task that handles the change)
+ *
+ * @param changed the changed fields among the subscribed ones
+ */
+typedef void (*DataModel_Callback_t)(DataModel_Fields_t changed);
+
+/**
+ * @brief call back when one of the fields changes, called before the scheduler
+ * starts, the callbacks are called in the order they subscribed
+ *
+ * @param fields mask of DM_ fields
+ * @param callback change callback
+ * @return ERROR_t E_OK or E_NOK for a NULL callback or a full table
+ */
+ERROR_t DataModel_subscribe(DataModel_Fields_t fields, DataModel_Callback_t callback);
+
+void DataModel_getSensorData(SensorData_t * pData);
+void DataModel_setSensorData(const SensorData_t * pData);
+
+void DataModel_getThreshold(SensorThreshold_t * pThreshold);
+void DataModel_setThreshold(const SensorThreshold_t * pThreshold);
+
+void DataModel_getMotors(Motors_t * pMotors);
+void DataModel_setMotors(const Motors_t * pMotors);
+
+/* one byte, read and written without a snapshot */
+SystemState_t DataModel_getState(void);
+void DataModel_setState(SystemState_t state);
+
+#endif /* DATAMODEL_H_ */
@@ -0,0 +1,101 @@
+/**
+ * @file screen.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief screen layouts and renderer of the display task header file
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * a screen is a table of fixed text lines and of fields (data model field,
+ * row, column, width, formatter), the renderer writes only the fields of the
+ * changed data model fields to the lcd frame buffer, the lcd driver then sends
+ * only the cells that really changed and skips the cursor command between
+ * adjacent cells
+ *
+ */
+
+#ifndef SCREEN_H_
+#define SCREEN_H_
+
+#include "std_types.h"
+#include "datamodel.h"
+#include "lcd.h"
+
+/* widest field, in characters */
+#define SCREEN_MAX_WIDTH	3
+
+/**
+ * @brief data shown on the screens, one copy of each data model group
+ *
+ */
+typedef struct
+{
+	SensorData_t Sensors;
+	SensorThreshold_t Threshold;
+	Motors_t Motors;
+} Screen_Data_t;
+
+/**
+ * @brief formatter of a field, writes the text of the field
+ *
+ * @param pData shown data
+ * @param pText at most the width of the field, the rest is cleared
+ * @return uint8 length of the text
+ */
+typedef uint8 (*Screen_Format_t)(const Screen_Data_t * pData, char * pText);
+
+/**
+ * @brief field of a screen
+ *
+ */
+typedef struct
+{
+	DataModel_Fields_t Field;
+	uint8 Row;
+	uint8 Col;
+	uint8 Width;
+	Screen_Format_t Format;
+} Screen_Field_t;
+
+/**
+ * @brief screen layout
+ *
+ */
+typedef struct
+{
+	const char * Lines[LCD_ROWS];	/* fixed text of each row, NULL for an empty row */
+	const Screen_Field_t * Fields;
+	uint8 FieldCount;
+} Screen_t;
+
+extern const Screen_t Screen_Main;
+extern const Screen_t Screen_Config;
+
+/* column of the threshold fields of the config screen, where the cursor waits */
+#define SCREEN_CONFIG_COL	14
+#define SCREEN_CONFIG_TEMP_ROW	0
+#define SCREEN_CONFIG_HUMI_ROW	2
+
+/* first glyph of the temperature and the humidity trends of the main screen */
+#define SCREEN_TEMP_TREND_GLYPH	0
+#define SCREEN_HUMI_TREND_GLYPH	4
+
+/**
+ * @brief draw a whole screen, the fixed text and all the fields
+ *
+ * @param pScreen screen layout
+ * @param pData shown data
+ */
+void Screen_draw(const Screen_t * pScreen, const Screen_Data_t * pData);
+
+/**
+ * @brief draw the fields of the changed data model fields
+ *
+ * @param pScreen screen layout
+ * @param pData shown data
+ * @param changed mask of DM_ fields
+ */
+void Screen_update(const Screen_t * pScreen, const Screen_Data_t * pData, DataModel_Fields_t changed);
+
+#endif /* SCREEN_H_ */
@@ -0,0 +1,62 @@
+/**
+ * @file snapshot.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief versioned snapshots of the data shared by the tasks header file
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * each data group has one writer and a sequence number next to it, the writer
+ * copies the new value and bumps the sequence, a reader copies the value and
+ * copies it again if the sequence moved meanwhile, so the reader gets all the
+ * fields of the same write without a critical section or a mutex
+ *
+ */
+
+#ifndef SNAPSHOT_H_
+#define SNAPSHOT_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+
+/**
+ * @brief sequence of a data group, one byte so it is read in one instruction
+ *
+ */
+typedef struct
+{
+	volatile uint8 Sequence;
+} Snapshot_t;
+
+/**
+ * @brief publish a new value of a data group, only called by its writer
+ *
+ * the copy is done with the interrupts disabled, it is a few bytes long and a
+ * reader with a higher priority than the writer never finds a write half
+ * done, it would wait for a task that can not run otherwise
+ *
+ * @param pSnap sequence of the data group
+ * @param pData the data group
+ * @param pValue new value
+ * @param size size of the data group in bytes
+ */
+void Snapshot_write(Snapshot_t * pSnap, void * pData, const void * pValue, uint8 size);
+
+/**
+ * @brief copy a data group, called by the readers
+ *
+ * the writer of the group reads it directly, nothing else writes it
+ *
+ * @param pSnap sequence of the data group
+ * @param pData the data group
+ * @param pCopy copy of the data group
+ * @param size size of the data group in bytes
+ */
+void Snapshot_read(const Snapshot_t * pSnap, const void * pData, void * pCopy, uint8 size);
+
+/* the same with the size taken from the data group */
+#define SNAPSHOT_WRITE(SNAP,DATA,VALUE)	Snapshot_write(&(SNAP), &(DATA), &(VALUE), sizeof(DATA))
+#define SNAPSHOT_READ(SNAP,DATA,COPY)	Snapshot_read(&(SNAP), &(DATA), &(COPY), sizeof(DATA))
+
+#endif /* SNAPSHOT_H_ */
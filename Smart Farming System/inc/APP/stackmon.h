@@ -0,0 +1,48 @@
+/**
+ * @file stackmon.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief tasks stack usage monitor header file
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef STACKMON_H_
+#define STACKMON_H_
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "std_types.h"
+
+/* max number of monitored tasks */
+#define STACKMON_MAX_TASKS		6
+
+/* bytes added to the deepest use seen to get the recommended stack size, covers
+ * an interrupt hitting the task at its deepest point (context save is 35 bytes)
+ * and code paths not run yet */
+#define STACKMON_MARGIN			40
+
+/**
+ * @brief add a task to the monitor, called once after the task creation
+ *
+ * @param task task handle
+ * @param size stack size given to the task in bytes (less than 256, the kernel
+ * reports the free space in a UBaseType_t)
+ * @return ERROR_t E_OK or E_NOK for a NULL handle or a full table
+ */
+ERROR_t StackMon_add(TaskHandle_t task, uint16 size);
+
+/**
+ * @brief send one line per task over the uart:
+ * "name size used recommended", in bytes
+ *
+ * the used bytes come from the 0xa5 fill pattern written by the kernel when the
+ * task is created, so they are the deepest use since the reset, not only since
+ * the last report
+ *
+ */
+void StackMon_report(void);
+
+#endif /* STACKMON_H_ */
@@ -0,0 +1,125 @@
+/**
+ * @file trace.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief kernel trace recorder header file, included from FreeRTOSConfig.h so
+ * the kernel trace hooks below replace the empty defaults of FreeRTOS.h
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+#include "std_types.h"
+
+/* 1 : record kernel events while the 'T' terminal command turned tracing on
+ * 0 : no trace hooks, the kernel is built without them */
+#define TRACE_ENABLE			1
+
+/* events held until the idle hook sends them, must be a power of 2 (max 128) */
+#define TRACE_BUFFER_EVENTS		32
+
+/* events sent in one uart frame, a frame must fit in the uart TX buffer */
+#define TRACE_FRAME_EVENTS		4
+
+/* bytes of one event: code, object, little endian low 16 bits of the time */
+#define TRACE_EVENT_SIZE		4
+
+/* uart frame: 'T', number of events, events, 8 bit sum of the bytes after 'T' */
+#define TRACE_FRAME_START		'T'
+#define TRACE_FRAME_SIZE(n)		(2 + ((n) * TRACE_EVENT_SIZE) + 1)
+
+/* event codes, the time of each event is the run time counter (timer 1 counts)
+ * of the port, the object is the priority of the task (every task of the
+ * application has its own) or the low byte of the queue / event group address */
+#define TRACE_EV_SYNC			0x00	/* time: high 16 bits of the time of the next events */
+#define TRACE_EV_LOST			0x01	/* object: events lost while the buffer was full */
+#define TRACE_EV_SWITCH_IN		0x02	/* task starts running */
+#define TRACE_EV_NOTIFY			0x03	/* task notified by a task */
+#define TRACE_EV_NOTIFY_ISR		0x04	/* task notified by an interrupt */
+#define TRACE_EV_NOTIFY_WAIT	0x05	/* task blocks waiting for a notification */
+#define TRACE_EV_DELAY			0x06	/* task blocks in vTaskDelay */
+#define TRACE_EV_QUEUE_SEND		0x07	/* queue send / semaphore give by a task */
+#define TRACE_EV_QUEUE_SEND_ISR	0x08	/* queue send / semaphore give by an interrupt */
+#define TRACE_EV_QUEUE_RECEIVE	0x09	/* queue receive / semaphore take */
+#define TRACE_EV_QUEUE_BLOCK	0x0A	/* task blocks on a queue receive / semaphore take */
+#define TRACE_EV_EVENT_SET		0x0B	/* event group bits set */
+#define TRACE_EV_EVENT_WAIT		0x0C	/* task blocks waiting for event group bits */
+#define TRACE_EV_COUNT			0x0D
+
+/**
+ * @brief record an event, called by the kernel hooks with interrupts enabled
+ * or disabled, does nothing while tracing is off
+ *
+ * @param event event code
+ * @param object task priority or object address low byte
+ */
+void Trace_record(uint8 event, uint8 object);
+
+/**
+ * @brief clear the buffer and start recording
+ *
+ */
+void Trace_start(void);
+
+/**
+ * @brief stop recording, the events already recorded are still sent
+ *
+ */
+void Trace_stop(void);
+
+/**
+ * @brief tell if the recording is on
+ *
+ * @return uint8 1 when on, 0 when off
+ */
+uint8 Trace_isRunning(void);
+
+/**
+ * @brief hold back the frames while a task sends a reply byte by byte, the
+ * events are still recorded and go out after Trace_resume()
+ *
+ */
+void Trace_pause(void);
+
+/**
+ * @brief let Trace_flush() send the frames again
+ *
+ */
+void Trace_resume(void);
+
+/**
+ * @brief send the recorded events while the uart TX buffer has room for a
+ * whole frame, never waits so it can be called from the idle hook, sends
+ * nothing while paused
+ *
+ */
+void Trace_flush(void);
+
+#if TRACE_ENABLE == 1
+
+/* these are expanded inside the kernel sources, pxTCB and pxCurrentTCB are the
+ * kernel TCB pointers and the queue / event group pointers are the kernel ones */
+#define TRACE_TASK(pxTask)				((uint8)((pxTask)->uxPriority))
+#define TRACE_OBJECT(pvObject)			((uint8)(size_t)(pvObject))
+
+#define traceTASK_SWITCHED_IN()			Trace_record(TRACE_EV_SWITCH_IN, TRACE_TASK(pxCurrentTCB))
+#define traceTASK_NOTIFY()				Trace_record(TRACE_EV_NOTIFY, TRACE_TASK(pxTCB))
+#define traceTASK_NOTIFY_FROM_ISR()		Trace_record(TRACE_EV_NOTIFY_ISR, TRACE_TASK(pxTCB))
+#define traceTASK_NOTIFY_GIVE_FROM_ISR()	Trace_record(TRACE_EV_NOTIFY_ISR, TRACE_TASK(pxTCB))
+#define traceTASK_NOTIFY_WAIT_BLOCK()	Trace_record(TRACE_EV_NOTIFY_WAIT, TRACE_TASK(pxCurrentTCB))
+#define traceTASK_NOTIFY_TAKE_BLOCK()	Trace_record(TRACE_EV_NOTIFY_WAIT, TRACE_TASK(pxCurrentTCB))
+#define traceTASK_DELAY()				Trace_record(TRACE_EV_DELAY, TRACE_TASK(pxCurrentTCB))
+#define traceQUEUE_SEND(pxQueue)		Trace_record(TRACE_EV_QUEUE_SEND, TRACE_OBJECT(pxQueue))
+#define traceQUEUE_SEND_FROM_ISR(pxQueue)	Trace_record(TRACE_EV_QUEUE_SEND_ISR, TRACE_OBJECT(pxQueue))
+#define traceQUEUE_RECEIVE(pxQueue)		Trace_record(TRACE_EV_QUEUE_RECEIVE, TRACE_OBJECT(pxQueue))
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue)	Trace_record(TRACE_EV_QUEUE_BLOCK, TRACE_OBJECT(pxQueue))
+#define traceEVENT_GROUP_SET_BITS(xEventGroup, uxBitsToSet)	Trace_record(TRACE_EV_EVENT_SET, TRACE_OBJECT(xEventGroup))
+#define traceEVENT_GROUP_WAIT_BITS_BLOCK(xEventGroup, uxBitsToWaitFor)	Trace_record(TRACE_EV_EVENT_WAIT, TRACE_OBJECT(xEventGroup))
+
+#endif /* TRACE_ENABLE */
+
+#endif /* TRACE_H_ */
@@ -0,0 +1,73 @@
+/**
+ * @file trend.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief bargraph of the last readings drawn with lcd glyphs header file
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * a trend keeps the last TREND_SAMPLES readings and draws them as bars, one
+ * pixel column per reading, in TREND_CELLS glyphs: the oldest on the left,
+ * a bar of TREND_THRESHOLD_LEVEL pixels is a reading at the threshold and
+ * a dotted line marks that level, the lcd driver sends a glyph only when its
+ * bitmap changed so a steady reading costs no CGRAM writes
+ *
+ */
+
+#ifndef TREND_H_
+#define TREND_H_
+
+#include "FreeRTOS.h"
+#include "std_types.h"
+#include "lcd.h"
+
+/* cells of a trend and readings shown, 5 pixel columns per cell */
+#define TREND_CELLS				4
+#define TREND_SAMPLES			(TREND_CELLS * 5)
+
+/* bar height of a reading at the threshold, the full height is twice it */
+#define TREND_THRESHOLD_LEVEL	(LCD_GLYPH_ROWS / 2)
+
+/* time between two readings, the bars cover the last minute */
+#define TREND_PERIOD_MS			3000
+#define TREND_PERIOD			((TickType_t)(TREND_PERIOD_MS / portTICK_PERIOD_MS))
+
+/**
+ * @brief last readings of one sensor
+ *
+ */
+typedef struct
+{
+	uint8 Samples[TREND_SAMPLES];	/* ring, the oldest at Head once full */
+	uint8 Head;
+	uint8 Count;
+	uint8 FirstGlyph;				/* glyphs FirstGlyph to FirstGlyph + TREND_CELLS - 1 */
+} Trend_t;
+
+/**
+ * @brief start an empty trend
+ *
+ * @param pTrend trend
+ * @param firstGlyph first of its lcd glyphs
+ */
+void Trend_init(Trend_t * pTrend, uint8 firstGlyph);
+
+/**
+ * @brief add a reading, the oldest one is dropped once full
+ *
+ * @param pTrend trend
+ * @param value reading
+ */
+void Trend_add(Trend_t * pTrend, uint8 value);
+
+/**
+ * @brief define the glyphs of the trend, to be done after each reading and
+ * each threshold change
+ *
+ * @param pTrend trend
+ * @param threshold threshold of the readings
+ */
+void Trend_draw(const Trend_t * pTrend, uint8 threshold);
+
+#endif /* TREND_H_ */
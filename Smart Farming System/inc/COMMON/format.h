@@ -0,0 +1,49 @@
+/**
+ * @file format.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief number to text formatting header file
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * the numbers are written right aligned in a fixed width, padded with spaces
+ * and without a terminator so the text can go straight to the lcd frame buffer
+ * or to the uart, the digits are taken out by subtracting the powers of ten
+ * (the avr has no divide instruction, itoa calls the 16-bit division routine
+ * once per digit)
+ *
+ */
+
+#ifndef FORMAT_H_
+#define FORMAT_H_
+
+#include "std_types.h"
+
+/* max number of digits */
+#define FORMAT_U8_DIGITS	3
+#define FORMAT_U16_DIGITS	5
+
+/**
+ * @brief write an unsigned 8-bit number
+ *
+ * @param value number to write
+ * @param pText at least the larger of width and FORMAT_U8_DIGITS characters
+ * @param width min number of characters, spaces are written before the digits,
+ * 0 for the digits only
+ * @return uint8 number of written characters
+ */
+uint8 Format_u8(uint8 value, char * pText, uint8 width);
+
+/**
+ * @brief write an unsigned 16-bit number
+ *
+ * @param value number to write
+ * @param pText at least the larger of width and FORMAT_U16_DIGITS characters
+ * @param width min number of characters, spaces are written before the digits,
+ * 0 for the digits only
+ * @return uint8 number of written characters
+ */
+uint8 Format_u16(uint16 value, char * pText, uint8 width);
+
+#endif /* FORMAT_H_ */
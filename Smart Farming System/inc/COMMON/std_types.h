@@ -26,4 +26,6 @@ typedef double f64;
 
 typedef enum {E_OK, E_NOK, PENDING} ERROR_t;
 
+#define NULL_PTR    ((void*)0)
+
 #endif /* STD_TYPE_H_ */
@@ -0,0 +1,67 @@
+/**
+ * @file calibration.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief per sensor calibration tables header file
+ * @version 0.1
+ * @date 2021-05-12
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#ifndef CALIBRATION_H_
+#define CALIBRATION_H_
+
+#include "std_types.h"
+#include "sensors.h"
+
+/* each table maps the raw 12 bit ADC value to the calibrated ADC value with
+ * CAL_POINTS breakpoints evenly spaced every 2^CAL_SEGMENT_BITS ADC steps */
+#define CAL_SEGMENT_BITS	9
+#define CAL_POINTS			((4096 >> CAL_SEGMENT_BITS) + 1)
+
+/* max calibrated ADC value, keeps the fixed point conversion inside 32 bits */
+#define CAL_MAX_VALUE		16383
+
+/**
+ * @brief load the calibration tables from EEPROM, sensors without a valid
+ * table get the identity table (calibrated value = raw value)
+ * 
+ */
+void Calibration_init(void);
+
+/**
+ * @brief calibrate a raw ADC value, takes the same time for any value
+ * 
+ * @param sensor sensor index
+ * @param adc raw 12 bit ADC value
+ * @return uint16 calibrated ADC value
+ */
+uint16 Calibration_apply(uint8 sensor, uint16 adc);
+
+/**
+ * @brief replace the table of a sensor, the tables are then saved to EEPROM
+ * by Calibration_flush()
+ * 
+ * @param sensor sensor index
+ * @param pPoints CAL_POINTS calibrated values at the breakpoints
+ * @return ERROR_t E_OK or E_NOK for a wrong sensor index or value
+ */
+ERROR_t Calibration_setTable(uint8 sensor, const uint16 * pPoints);
+
+/**
+ * @brief save the changed tables to EEPROM, starts at most one EEPROM write
+ * (about 8.5 ms) and returns without waiting for it, to be called from the
+ * idle hook until Calibration_isSaving() is 0
+ * 
+ */
+void Calibration_flush(void);
+
+/**
+ * @brief tell if a save to EEPROM is in progress
+ * 
+ * @return uint8 1 until the last table set is saved, 0 then
+ */
+uint8 Calibration_isSaving(void);
+
+#endif /* CALIBRATION_H_ */
@@ -42,6 +42,33 @@
 #define CURSOR_ON 0x0E
 #define CURSOR_BLINK 0x0F
 #define SET_CURSOR_LOCATION 0x80 
+#define SET_CGRAM_ADDRESS 0x40
+
+/* LCD size */
+#define LCD_ROWS 4
+#define LCD_COLS 20
+
+/* custom characters in the lcd CGRAM, 8 glyphs of 8 rows of 5 pixels */
+#define LCD_GLYPHS 8
+#define LCD_GLYPH_ROWS 8
+
+/* char code of a glyph, the lcd shows glyph 0-7 at 0-7 and again at 8-15,
+ * the second set keeps the '\0' out of the strings */
+#define LCD_GLYPH(INDEX) (8 + (INDEX))
+
+/**
+ * @brief lcd bus transfers since the reset, a transfer is one command or data
+ * byte (two strobes in 4-bit mode), the counters wrap around
+ * 
+ */
+typedef struct
+{
+	uint16 Flushes;		/* LCD_flush() calls that sent something */
+	uint16 Commands;	/* command bytes, cursor moves included */
+	uint16 Data;		/* data bytes */
+	uint16 Last;		/* transfers of the last of these flushes */
+	uint16 Glyphs;		/* glyphs sent to the CGRAM */
+} LCD_Stats_t;
 
 /**
  * @brief send command to lcd
@@ -51,7 +78,8 @@
 void LCD_sendCommand(uint8 command);
 
 /**
- * @brief display char on lcd
+ * @brief display char on lcd at the current cursor position,
+ * the char is written in the frame buffer and sent by LCD_flush()
  * 
  * @param data char to display
  */
@@ -65,7 +93,7 @@ void LCD_displayCharacter(uint8 data);
 void LCD_displayString(const char *Str);
 
 /**
- * @brief initialize lcd 
+ * @brief initialize lcd and the frame buffer
  * 
  */
 void LCD_init(void);
@@ -100,4 +128,46 @@ void LCD_goToRowColumn(uint8 row,uint8 col);
  */
 void LCD_intgerToString(int data);
 
+/**
+ * @brief display a number right aligned in a fixed width, the cells before
+ * the digits get spaces so the old value needs no clearing first
+ * 
+ * @param value number to display
+ * @param width min number of cells, 0 for the digits only
+ */
+void LCD_displayNumber(uint16 value, uint8 width);
+
+/**
+ * @brief set cursor mode, applied by the next LCD_flush()
+ * 
+ * @param mode CURSOR_OFF, CURSOR_ON or CURSOR_BLINK
+ */
+void LCD_setCursorMode(uint8 mode);
+
+/**
+ * @brief send the changed frame buffer cells to the lcd,
+ * must be called from one low priority context only
+ * 
+ */
+void LCD_flush(void);
+
+/**
+ * @brief define a custom character, it is sent by LCD_flush() only when the
+ * bitmap differs from the one the lcd already has, the cells showing
+ * LCD_GLYPH(index) change with it without being written again
+ * 
+ * @param index glyph 0 to LCD_GLYPHS - 1
+ * @param pBitmap LCD_GLYPH_ROWS rows from the top, the 5 low bits of each
+ * row are the pixels, bit 4 on the left
+ * @return ERROR_t E_OK or E_NOK for a wrong index
+ */
+ERROR_t LCD_defineGlyph(uint8 index, const uint8 * pBitmap);
+
+/**
+ * @brief copy the bus transfer counters
+ * 
+ * @param pStats counters
+ */
+void LCD_getStats(LCD_Stats_t * pStats);
+
 #endif /* LCD_H_ */
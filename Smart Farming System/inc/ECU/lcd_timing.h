@@ -0,0 +1,59 @@
+/**
+ * @file lcd_timing.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief HD44780 bus timing used by the lcd driver
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef LCD_TIMING_H_
+#define LCD_TIMING_H_
+
+#include "micro_config.h"
+#include "std_types.h"
+
+/* 1 : wait for the busy flag (DB7) by reading the lcd through RW before each transfer
+ * 0 : wait the worst case execution time after each transfer */
+#define LCD_USE_BUSY_FLAG		1
+
+/********************* HD44780 write/read cycle (ns) *********************/
+/* RS, R/W setup time before E rise */
+#define LCD_T_AS_NS				40
+/* E high pulse width */
+#define LCD_T_PW_EH_NS			230
+/* E cycle time, E rise to next E rise */
+#define LCD_T_CYCLE_E_NS		500
+/* data setup time before E fall */
+#define LCD_T_DSW_NS			80
+/* data / address hold time after E fall */
+#define LCD_T_H_NS				10
+/* data output delay after E rise when reading */
+#define LCD_T_DDR_NS			160
+
+/******************** HD44780 execution time (us) ***********************/
+/* clear display and return home */
+#define LCD_T_EXEC_CLEAR_US		1520
+/* all other instructions and data writes */
+#define LCD_T_EXEC_US			37
+
+/* max busy flag reads before giving up, avoids hanging when no lcd is connected,
+ * the waits of the reads alone (an E cycle each) cover twice the clear time */
+#define LCD_BUSY_POLL_MAX		((2000UL * LCD_T_EXEC_CLEAR_US) / LCD_T_CYCLE_E_NS)
+
+/* cpu cycles needed to cover a time in ns, rounded up plus one cycle margin for the port write */
+#define LCD_NS_TO_CYCLES(ns)	( ( ( (uint32)(ns) * (F_CPU / 1000000UL) ) + 999UL ) / 1000UL + 1UL )
+
+#ifdef SFS_SIM_PORT
+/* the host simulation does not wait, its lcd model samples the bus pins at
+ * each wait and moves its bus clock instead (sim/src/ECU/lcd_model.c) */
+void LCD_simWait(uint16 ns);
+#define LCD_DELAY_NS(ns)		LCD_simWait(ns)
+#else
+/* busy wait at least ns nanoseconds, a few cycles at 8 MHz */
+#define LCD_DELAY_NS(ns)		__builtin_avr_delay_cycles(LCD_NS_TO_CYCLES(ns))
+#endif
+
+#endif /* LCD_TIMING_H_ */
@@ -12,15 +12,68 @@
 #ifndef HAL_SENSORS_SENSORS_H_
 #define HAL_SENSORS_SENSORS_H_
 
-//#include "ADC_interface.h"
 #include "std_types.h"
+#include "adc.h"
 
 /* define pins for temperature and humidity seneors */
 #define TEMP_SENSOR_CH 0
 #define HUMI_SENSOR_CH 1
 
+/* position of each sensor in the ADC scan, new sensors are added at the end */
+#define TEMP_SENSOR_IDX 0
+#define HUMI_SENSOR_IDX 1
+#define SENSORS_COUNT   2
+
+/* decimated samples averaged by the moving average filter, must be a power of 2 */
+#define SENSORS_FILTER_LEN      4
+
+/* new filtered samples between two callbacks, each decimated sample takes
+ * SENSORS_COUNT * ADC_OVERSAMPLE_COUNT / ADC_TRIGGER_HZ = 128 ms so about 500 ms */
+#define SENSORS_PUBLISH_EVERY   4
+
+/* min change of the filtered ADC value reported as a new reading, 4 / 4096 of
+ * full scale is about 0.5 degree, hides the +-1 jitter around a value */
+#define SENSORS_DEADBAND        4
+
+/* sensor value per 12 bit ADC step multiplied by 100, 48.80 / 4 for the 2 extra bits */
+#define TEMP_SCALE_X100     1220
+#define HUMI_SCALE_X100     1220
+
+/* fraction bits of the fixed point scale factors, 21 bits keep
+ * (adc * factor) >> 21 equal to (uint16)(adc * scale) / 100 for all 4096 codes
+ * and inside 32 bits up to CAL_MAX_VALUE */
+#define SENSORS_Q_BITS      21
+
+/* fixed point factor of scale / 100 rounded up, computed at compile time */
+#define SENSORS_Q_FACTOR(scale_x100)  ( ( ( (uint32)(scale_x100) << SENSORS_Q_BITS ) + 9999UL ) / 10000UL )
+
+/**
+ * @brief convert ADC value to sensor value with integer math only
+ * 
+ * @param adc calibrated ADC value
+ * @param factor SENSORS_Q_FACTOR of the sensor scale
+ * @return uint16 sensor value
+ */
+static inline uint16 Sensors_convert(uint16 adc, uint32 factor)
+{
+	return (uint16)(((uint32)adc * factor) >> SENSORS_Q_BITS);
+}
+
+/**
+ * @brief configure the ADC scan with all sensor channels
+ * 
+ * @param callback called from the ADC interrupt each SENSORS_PUBLISH_EVERY filtered samples
+ */
+void Sensors_init(ADC_ScanCallback_t callback);
+
+/**
+ * @brief start sampling all sensors continuously
+ * 
+ */
+void Sensors_startScan(void);
+
 /**
- * @brief read temperature value
+ * @brief read filtered temperature value
  * 
  * @param pTemp store temp value in this pointer
  * @return ERROR_t result of reading operation E_OK, E_NOK, PENDING
@@ -28,7 +81,7 @@
 ERROR_t TEMP_u16_Read(uint16 * pTemp);
 
 /**
- * @brief read humidity value
+ * @brief read filtered humidity value
  * 
  * @param pHumi store humi value in this pointer
  * @return ERROR_t result of reading operation E_OK, E_NOK, PENDING
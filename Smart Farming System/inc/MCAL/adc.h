@@ -16,6 +16,21 @@
 #include "std_types.h"
 #include "common_macros.h"
 
+/* max number of channels converted in one scan */
+#define ADC_MAX_SCAN_CHANNELS 8
+
+/* extra resolution bits by oversampling, each published sample is the sum of
+ * 4^ADC_OVERSAMPLE_BITS conversions shifted right by ADC_OVERSAMPLE_BITS (0 --> 3) */
+#define ADC_OVERSAMPLE_BITS 2
+#define ADC_OVERSAMPLE_COUNT (1 << (2 * ADC_OVERSAMPLE_BITS))
+
+/* conversions per second in continuous scan, triggered by timer0 compare match
+ * with F_CPU/1024 clock so it must be from 31 to 7812 */
+#define ADC_TRIGGER_HZ 250
+
+/* function called from the ADC interrupt when a full scan completes */
+typedef void (*ADC_ScanCallback_t)(void);
+
 /*
  * Description :
  * Function responsible for initialize the ADC driver.
@@ -26,7 +41,42 @@ void ADC_init(void);
  * Description :
  * Function responsible for read analog data from a certain ADC channel
  * and convert it to digital using the ADC driver.
+ * Busy waits for the conversion, must not be used while a scan is running.
  */
 uint16 ADC_readChannel(uint8 channel_num);
 
+/*
+ * Description :
+ * Set the list of channels converted in order by each scan and the
+ * function called from the ADC interrupt when the scan completes.
+ */
+void ADC_setScan(const uint8 * pChannels, uint8 count, ADC_ScanCallback_t callback);
+
+/*
+ * Description :
+ * Start converting the scan channels once, each conversion is started from
+ * the ADC interrupt of the previous one so the caller never busy waits.
+ */
+void ADC_startScan(void);
+
+/*
+ * Description :
+ * Keep converting the scan channels, one conversion every timer0 compare
+ * match, the callback is called each time a new set of samples is published.
+ */
+void ADC_startContinuousScan(void);
+
+/*
+ * Description :
+ * Stop the running scan.
+ */
+void ADC_stopScan(void);
+
+/*
+ * Description :
+ * Get the sample of the scan channel at index from the last completed scan,
+ * the sample has 10 + ADC_OVERSAMPLE_BITS bits.
+ */
+uint16 ADC_getSample(uint8 index);
+
 #endif /* ADC_H_ */
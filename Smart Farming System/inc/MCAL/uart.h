@@ -15,29 +15,75 @@
 #include "micro_config.h"
 #include "std_types.h"
 #include "common_macros.h"
+#include "FreeRTOS.h"
+
+/* RX and TX ring buffer sizes in bytes, must be a power of 2 (max 128) */
+#define UART_RX_BUFFER_SIZE		16
+#define UART_TX_BUFFER_SIZE		32
 
 /**
- * @brief initialize uart
+ * @brief initialize uart, RX complete interrupt is enabled and the data
+ * register empty interrupt is enabled on demand when TX data is queued
  * 
  */
 void UART_init(void);
 
 /**
- * @brief send byte through uart 
+ * @brief queue bytes for transmission without blocking
+ * 
+ * @param pBuf bytes to send
+ * @param len number of bytes to send
+ * @return uint8 number of bytes actually queued (less than len if TX buffer is full)
+ */
+uint8 UART_write(const uint8 * pBuf, uint8 len);
+
+/**
+ * @brief queue a whole frame for transmission without blocking, so no other
+ * bytes are sent in the middle of it
+ * 
+ * @param pBuf frame bytes
+ * @param len frame length, less than UART_TX_BUFFER_SIZE
+ * @return ERROR_t E_OK when queued, E_NOK when the TX buffer has no room for
+ * all of it (nothing is queued)
+ */
+ERROR_t UART_writeFrame(const uint8 * pBuf, uint8 len);
+
+/**
+ * @brief read received bytes, the calling task sleeps until bytes arrive
+ * 
+ * @param pBuf buffer to store received bytes
+ * @param len max number of bytes to read
+ * @param xTimeout max ticks to wait for each byte
+ * @return uint8 number of bytes actually read (less than len on timeout)
+ */
+uint8 UART_read(uint8 * pBuf, uint8 len, TickType_t xTimeout);
+
+/**
+ * @brief send byte through uart, waits only if the TX buffer is full: the
+ * calling task sleeps until the UDRE ISR frees an entry, with the interrupts
+ * disabled the oldest byte is sent by polling
  * 
  * @param data byte to send
  */
 void UART_sendByte(const uint8 data);
 
 /**
- * @brief receive byte through uart
+ * @brief send all the queued bytes by polling, for when the interrupts are
+ * disabled for good (e.g. a fatal error report) and the UDRE ISR will never
+ * drain the TX buffer, does nothing while the interrupts are enabled
+ * 
+ */
+void UART_flushPolled(void);
+
+/**
+ * @brief receive byte through uart, the calling task sleeps until a byte arrives
  * 
  * @return uint8 received byte
  */
 uint8 UART_receiveByte(void);
 
 /**
- * @brief receive byte through uart without polling
+ * @brief receive byte through uart without waiting
  * 
  * @param pData received byte
  * @return ERROR_t result of receiving operation E_OK, E_NOK, PENDING
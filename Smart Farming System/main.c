@@ -12,22 +12,54 @@
 
 #include "app.h"
 
+/* tasks memory, there is no heap (configSUPPORT_DYNAMIC_ALLOCATION = 0) */
+static StackType_t T_DisplayStack[T_DISPLAY_STACK];
+static StackType_t T_SensingStack[T_SENSING_STACK];
+static StackType_t T_TerminalStack[T_TERMINAL_STACK];
+static StackType_t T_SysCheckStack[T_SYSCHECK_STACK];
+static StackType_t T_ControlStack[T_CONTROL_STACK];
+static StackType_t T_IdleStack[T_IDLE_STACK];
+
+static StaticTask_t T_DisplayTCB;
+static StaticTask_t T_SensingTCB;
+static StaticTask_t T_TerminalTCB;
+static StaticTask_t T_SysCheckTCB;
+static StaticTask_t T_ControlTCB;
+static StaticTask_t T_IdleTCB;
+
+/* tasks handles, the data model callbacks notify the tasks through them */
+static TaskHandle_t thControl = NULL;
+static TaskHandle_t thSysCheck = NULL;
+static TaskHandle_t thSensing = NULL;
+static TaskHandle_t thTerminal = NULL;
+static TaskHandle_t thDisplay = NULL;
+
+/* readings shown as bars on the main screen, kept by T_Display */
+static Trend_t TempTrend;
+static Trend_t HumiTrend;
+
 int main(void)
 {
 	/* os init */
 	System_Init();
 
 	/* OS Object Creation */
-	egControl = xEventGroupCreate();
-	egDisplay = xEventGroupCreate();
-	bsCheck = xSemaphoreCreateBinary();
-
-	/* tasks creation with different priorities */
-	xTaskCreate(T_Display, 	 NULL, 200, NULL, 2, NULL);
-	xTaskCreate(T_Sensing, 	 NULL, 100,  NULL, 3, NULL);
-	xTaskCreate(T_Terminal,  NULL, 150, NULL, 4, NULL);
-	xTaskCreate(T_SysCheck,  NULL, 100,  NULL, 5, NULL);
-	xTaskCreate(T_Control,	 NULL, 150, NULL, 6, NULL);
+	/* tasks creation with different priorities, the tasks signal each other
+	 * with direct to task notifications so no other OS objects are needed */
+	thDisplay  = xTaskCreateStatic(T_Display,  "DISP",  T_DISPLAY_STACK,  NULL, 2, T_DisplayStack,  &T_DisplayTCB);
+	thSensing  = xTaskCreateStatic(T_Sensing,  "SENS",  T_SENSING_STACK,  NULL, 3, T_SensingStack,  &T_SensingTCB);
+	thTerminal = xTaskCreateStatic(T_Terminal, "TERM",  T_TERMINAL_STACK, NULL, 4, T_TerminalStack, &T_TerminalTCB);
+	thSysCheck = xTaskCreateStatic(T_SysCheck, "CHECK", T_SYSCHECK_STACK, NULL, 5, T_SysCheckStack, &T_SysCheckTCB);
+	thControl  = xTaskCreateStatic(T_Control,  "CTRL",  T_CONTROL_STACK,  NULL, 6, T_ControlStack,  &T_ControlTCB);
+
+	/* stack use report ('S' terminal command), the handle of a static task is
+	 * its TCB so the idle task is known before the scheduler creates it */
+	StackMon_add(thDisplay,  T_DISPLAY_STACK);
+	StackMon_add(thSensing,  T_SENSING_STACK);
+	StackMon_add(thTerminal, T_TERMINAL_STACK);
+	StackMon_add(thSysCheck, T_SYSCHECK_STACK);
+	StackMon_add(thControl,  T_CONTROL_STACK);
+	StackMon_add((TaskHandle_t)&T_IdleTCB, T_IDLE_STACK);
 
 	/* start scheduling */
 	vTaskStartScheduler();
@@ -37,114 +69,148 @@ int main(void)
 /**
  * @brief Control heater, cooler and water pump
  * 
+ * Actuators_DataChanged notifies the wanted state of all actuators (E_PUMP,
+ * E_HEATER, E_COOLER bits) when T_SysCheck changes the motors in the data
+ * model, a newer state overwrites one not taken yet. T_Control has the highest
+ * priority, so it is applied before xTaskNotify returns, no tick passes
+ * between the sensor reading and the GPIO change, and before the display
+ * (subscribed after it) is told about the change. The 'T' trace measures it,
+ * tracedec prints it as the SENS scan -> CTRL running latency.
+ * 
  * @param pvParam 
  */
 void T_Control(void* pvParam)
 {
+	uint32_t state;
 		
 	while(1)
 	{
-		ebControlBits = xEventGroupWaitBits(egControl, E_CONTROLMASK , 0, 0, portMAX_DELAY);
+		if(pdFALSE == xTaskNotifyWait(0, 0, &state, portMAX_DELAY))
+		{
+			continue;
+		}
 
-		if ( (ebControlBits & E_HEATER) == E_HEATER )
+		/* update heater state */
+		if( (state & E_HEATER) == E_HEATER )
 		{
-			/* update heater state */
-			if(Motors_State.Heater == ON)
-			{
-				SET_BIT(PORTD,HEATER);
-			}
-			else
-			{
-				CLEAR_BIT(PORTD,HEATER);
-			}
+			SET_BIT(PORTD,HEATER);
+		}
+		else
+		{
+			CLEAR_BIT(PORTD,HEATER);
 		}
 
-		if( (ebControlBits & E_COOLER) == E_COOLER )
+		/* update cooler state */ 
+		if( (state & E_COOLER) == E_COOLER )
 		{
-			/* update cooler state */ 
-			if(Motors_State.Cooler == ON)
-			{
-				SET_BIT(PORTD,COOLER);
-			}
-			else
-			{
-				CLEAR_BIT(PORTD,COOLER);
-			}
+			SET_BIT(PORTD,COOLER);
+		}
+		else
+		{
+			CLEAR_BIT(PORTD,COOLER);
 		}
 
 
-		if( (ebControlBits & E_PUMP) == E_PUMP )
+		/* update water pump state */
+		if( (state & E_PUMP) == E_PUMP )
 		{
-			/* update water pump state */
-			if(Motors_State.Water_Pump == ON)
-			{
-				SET_BIT(PORTD,WATER_PUMP);
-			}
-			else
-			{
-				CLEAR_BIT(PORTD,WATER_PUMP);
-			}
+			SET_BIT(PORTD,WATER_PUMP);
+		}
+		else
+		{
+			CLEAR_BIT(PORTD,WATER_PUMP);
 		}
-		vTaskDelay(5);
 	}
 }
 
 /**
- * @brief check current readings form the sensor with threshold values */
+ * @brief data model callback of the motors, runs in T_SysCheck
+ * 
+ */
+void Actuators_DataChanged(DataModel_Fields_t changed)
+{
+	Motors_t motors;
+	uint32_t actuators = 0;
+
+	(void)changed;
+
+	/* the whole state is sent, T_Control sets all the outputs */
+	DataModel_getMotors(&motors);
+	if(motors.Water_Pump == ON)
+	{
+		actuators |= E_PUMP;
+	}
+	if(motors.Heater == ON)
+	{
+		actuators |= E_HEATER;
+	}
+	if(motors.Cooler == ON)
+	{
+		actuators |= E_COOLER;
+	}
+
+	xTaskNotify(thControl, actuators, eSetValueWithOverwrite);
+}
+
+/**
+ * @brief check current readings form the sensor with threshold values
  * 
  * @param pvParam 
  */
 void T_SysCheck(void* pvParam)
 {
-	/* initial defaults */
-	xEventGroupSetBits(egDisplay, E_MainScreen); 
-	xEventGroupClearBits(egControl, E_CONTROLMASK);
+	TickType_t xWait = portMAX_DELAY;
+	TickType_t xNow;
+	SensorData_t data;
+	SensorThreshold_t threshold;
+	Motors_t motors;
+
+	/* initial defaults, the screen of the system state */
+	xTaskNotify(thDisplay, DM_STATE, eSetBits); 
 
 	while(1)
 	{
-		if(xSemaphoreTake(bsCheck, portMAX_DELAY))
-		{
-			if(SFS.SensorData.TempData > SFS.SensorThreshold.TempT)
-			{
-				Motors_State.Cooler = ON;
-				Motors_State.Heater = OFF;
-			}
-			else if(SFS.SensorData.TempData < SFS.SensorThreshold.TempT)
-			{
-				Motors_State.Cooler = OFF;
-				Motors_State.Heater = ON;
-			}
-			else  /* when equal */
-			{
-				Motors_State.Cooler = OFF;
-				Motors_State.Heater = OFF;
-			}
+		/* woken up by a new reading or threshold (SysCheck_DataChanged), also
+		 * when a held back change is allowed or a PID slot ends */
+		ulTaskNotifyTake(pdTRUE, xWait);
 
-			xEventGroupSetBits(egControl, E_COOLER | E_HEATER);
-			vTaskDelay(10);
-			xEventGroupClearBits(egControl, E_COOLER | E_HEATER);
+		xNow = xTaskGetTickCount();
+		xWait = portMAX_DELAY;
 
-			if(SFS.SensorData.HumiData >= SFS.SensorThreshold.HumiT)
-			{
-				Motors_State.Water_Pump = OFF;
-			}
-			else
-			{
-				Motors_State.Water_Pump = ON;
-			}
+		/* readings and thresholds of the same update */
+		DataModel_getSensorData(&data);
+		DataModel_getThreshold(&threshold);
+		DataModel_getMotors(&motors);
 
-			xEventGroupSetBits(egControl, E_PUMP);
-			vTaskDelay(10);
-			xEventGroupClearBits(egControl, E_PUMP);
+		motors.Cooler = Control_update(CONTROL_COOLER, (sint16)data.TempData - threshold.TempT, xNow, &xWait) ? ON : OFF;
 
-			xEventGroupSetBits(egDisplay, E_MotorState); 
-		}
+		/* heater is kept off while the cooler is still on */
+		Control_interlock(CONTROL_HEATER, ON == motors.Cooler);
+		motors.Heater = Control_update(CONTROL_HEATER, (sint16)threshold.TempT - data.TempData, xNow, &xWait) ? ON : OFF;
+
+		motors.Water_Pump = Control_update(CONTROL_PUMP, (sint16)threshold.HumiT - data.HumiData, xNow, &xWait) ? ON : OFF;
 
+		/* the subscribers (T_Control, then T_Display) are only called when an
+		 * actuator changed */
+		DataModel_setMotors(&motors);
 	}
 }
 
 /**
- * @brief take input from user
+ * @brief data model callback of the readings and the thresholds, runs in
+ * T_Sensing or T_Terminal
+ * 
+ */
+void SysCheck_DataChanged(DataModel_Fields_t changed)
+{
+	(void)changed;
+
+	/* wake up system check */
+	xTaskNotifyGive(thSysCheck);
+}
+
+/**
+ * @brief take input from user, handles each byte as soon as it is received
  * 
  * @param pvParam 
  */
@@ -153,6 +219,7 @@ void T_Terminal(void* pvParam)
 	uint8 data;
 	uint8 strTTemp[4];
 	uint8 strTHumi[4];
+	SensorThreshold_t threshold;
 	
 	/* clear two arrays */
 	memset(strTTemp, 0, 3);
@@ -167,176 +234,378 @@ void T_Terminal(void* pvParam)
 
 	while(1)
 	{
+		/* sleep until the UART RX interrupt receives a new byte */
+		data = UART_receiveByte();
+
 		switch (ReceivingState)
 		{
 			case TempReceiving:
 			{
-				if(E_OK == UART_receiveByte_NonBlocking(&data))
+				if(MainState == DataModel_getState() )
 				{
-					if(MainState == SFS.SystemState )
+					/* the data is 'C' configuration */
+					if('C' == data)	
 					{
-						/* the data is 'C' configuration */
-						if('C' == data)	
-						{
-							SFS.SystemState = ConfigState;
-							/* clearing index to start saving from zero in next config */
-							i = 0; 	
-							/* clear temporary data for next config */
-							memset(strTHumi, 0, 3);  
-							/* config screen */
-							xEventGroupSetBits(egDisplay, E_ConfigScreen); 
-						}
+						/* clearing index to start saving from zero in next config */
+						i = 0; 	
+						/* clear temporary data for next config */
+						memset(strTHumi, 0, 3);  
+						/* config screen (Display_DataChanged) */
+						DataModel_setState(ConfigState);
 					}
-					
-					else if (ConfigState == SFS.SystemState)
-					{
-						if('C' == data)	/* the data is 'C' cancell */
-						{
-							SFS.SystemState = MainState;
-							/* Display main */
-							xEventGroupSetBits(egDisplay, E_MainScreen); 
-							/* clear temporary data for next config */
-							memset(strTTemp, 0, 3);  
-						}
 
-						else if(data >= '0' && data <= '9')	/* the data is digit */
-						{
-							/* receive till the max 3 digits */
-							if(i<3)	
-							{
-								strTTemp[i] = data;
-								i++;
-							}
-						}
-						
-						/* the data is 'O' */
-						else if( 'O' == data)	
+					/* the data is 'K' calibration table upload */
+					else if('K' == data)
+					{
+						Terminal_Calibration();
+					}
+					/* the data is 'P' control mode and gains */
+					else if('P' == data)
+					{
+						Terminal_Tuning();
+					}
+					/* the data is 'S' stack use report */
+					else if('S' == data)
+					{
+						StackMon_report();
+					}
+					/* the data is 'R' tasks run time dump */
+					else if('R' == data)
+					{
+						Terminal_RunStats();
+					}
+					/* the data is 'L' lcd bus transfers */
+					else if('L' == data)
+					{
+						Terminal_LcdStats();
+					}
+					/* the data is 'T' kernel trace on / off */
+					else if('T' == data)
+					{
+						if(Trace_isRunning())
 						{
-							/* Do not update the global struct if no data exist */
-							if( 0 == atoi(strTTemp) )
-							{
-								/* clear temporary data */
-								memset(strTTemp, 0, 3); 
-							}
-							
-							else
-							{
-								/* update global threshold*/
-								SFS.SensorThreshold.TempT = atoi(strTTemp);
-								/* clear temporary data */
-								memset(strTTemp, 0, 3); 
-
-								/* give semaphore to system check */
-								xSemaphoreGive(bsCheck);
-								xEventGroupSetBits(egDisplay, E_TTUpdated);
-							}
-
-							i = 0;
-							/* Go to Humidity receiving state */
-							ReceivingState = HumiReceiving; 	
-							/* in both situation, move the cursor to humidity*/
-							xEventGroupSetBits(egDisplay, E_Next); 
+							Trace_stop();
+							UART_sendString("TRACE OFF\r\n");
 						}
-						
-						/* the data is 'N' */
-						else if( 'N' == data)	
+						else
 						{
-							/* to start from zero in Humidity receiving */
-							i = 0; 
-							/* clear temporary data */
-							memset(strTTemp, 0, 3);  
-							/* Go to Humidity receiving state */
-							ReceivingState = HumiReceiving; 	
-							/* tell the display to move the cursor */
-							xEventGroupSetBits(egDisplay, E_Next); 
+							UART_sendString("TRACE ON\r\n");
+							Trace_start();
 						}
-						
-					} /* end IF ConfigState */
-						
-				} /* end if Data exist in uart */
-			}break;
-			
-			case HumiReceiving:
-			{
-				/* if new data exist on terminal */
-				if(E_OK == UART_receiveByte_NonBlocking(&data)) 
+					}
+				}
+				
+				else if (ConfigState == DataModel_getState())
 				{
-					/* the data is 'C' cancell */
-					if('C' == data)	
+					if('C' == data)	/* the data is 'C' cancell */
 					{
-						ReceivingState = TempReceiving;
-						/* clearing index to start saving from zero in next config */
-						i = 0; 	
-						/* clear temporary data for next config */
-						memset(strTHumi, 0, 3);  
-						SFS.SystemState = MainState;
 						/* Display main */
-						xEventGroupSetBits(egDisplay, E_MainScreen); 
+						DataModel_setState(MainState);
+						/* clear temporary data for next config */
+						memset(strTTemp, 0, 3);  
 					}
-					
-					/* the data is digit */
-					else if( '9' >= data && '0' <= data)	
+
+					else if(data >= '0' && data <= '9')	/* the data is digit */
 					{
-						/* receive till max 3 digits */
-						if(3 > i)	
+						/* receive till the max 3 digits */
+						if(i<3)	
 						{
-							strTHumi[i] = data;
+							strTTemp[i] = data;
 							i++;
 						}
-									
 					}
 					
 					/* the data is 'O' */
-					else if('O' == data)	
+					else if( 'O' == data)	
 					{
-						/* if there is no data received in humi */
-						if( 0 == atoi(strTHumi) )  
+						/* Do not update the global struct if no data exist */
+						if( 0 == atoi(strTTemp) )
 						{
 							/* clear temporary data */
 							memset(strTTemp, 0, 3); 
 						}
+						
 						else
 						{
-							/* update global threshold*/
-							SFS.SensorThreshold.HumiT = atoi(strTHumi);	
+							/* update global threshold, wakes up system check and the display */
+							DataModel_getThreshold(&threshold);
+							threshold.TempT = atoi(strTTemp);
+							DataModel_setThreshold(&threshold);
 							/* clear temporary data */
-							memset(strTTemp, 0, 3);  
-							/* give semaphore to system check */
-							xSemaphoreGive(bsCheck);
-							xEventGroupSetBits(egDisplay, E_HTUpdated);
-							vTaskDelay(500);
+							memset(strTTemp, 0, 3); 
 						}
 
-						/* next state */
-						ReceivingState = TempReceiving; 
-						SFS.SystemState = MainState;
-
-						/* in both cases go to main screen */
-						xEventGroupSetBits(egDisplay, E_MainScreen); 
-
+						i = 0;
+						/* Go to Humidity receiving state */
+						ReceivingState = HumiReceiving; 	
+						/* in both situation, move the cursor to humidity*/
+						xTaskNotify(thDisplay, E_Next, eSetBits); 
 					}
 					
 					/* the data is 'N' */
-					else if('N' == data)	
+					else if( 'N' == data)	
+					{
+						/* to start from zero in Humidity receiving */
+						i = 0; 
+						/* clear temporary data */
+						memset(strTTemp, 0, 3);  
+						/* Go to Humidity receiving state */
+						ReceivingState = HumiReceiving; 	
+						/* tell the display to move the cursor */
+						xTaskNotify(thDisplay, E_Next, eSetBits); 
+					}
+					
+				} /* end IF ConfigState */
+					
+			}break;
+			
+			case HumiReceiving:
+			{
+				/* the data is 'C' cancell */
+				if('C' == data)	
+				{
+					ReceivingState = TempReceiving;
+					/* clearing index to start saving from zero in next config */
+					i = 0; 	
+					/* clear temporary data for next config */
+					memset(strTHumi, 0, 3);  
+					/* Display main */
+					DataModel_setState(MainState);
+				}
+				
+				/* the data is digit */
+				else if( '9' >= data && '0' <= data)	
+				{
+					/* receive till max 3 digits */
+					if(3 > i)	
+					{
+						strTHumi[i] = data;
+						i++;
+					}
+								
+				}
+				
+				/* the data is 'O' */
+				else if('O' == data)	
+				{
+					/* if there is no data received in humi */
+					if( 0 == atoi(strTHumi) )  
 					{
-						/* set receiving state in next time to temp */
-						ReceivingState = TempReceiving; 	
-						SFS.SystemState = MainState;
-
-						xEventGroupSetBits(egDisplay, E_MainScreen);
 						/* clear temporary data */
 						memset(strTTemp, 0, 3); 
 					}
-				} /* end of if data exist in uart */
+					else
+					{
+						/* update global threshold, wakes up system check and the display */
+						DataModel_getThreshold(&threshold);
+						threshold.HumiT = atoi(strTHumi);
+						DataModel_setThreshold(&threshold);
+						/* clear temporary data */
+						memset(strTTemp, 0, 3);  
+						vTaskDelay(500);
+					}
+
+					/* next state */
+					ReceivingState = TempReceiving; 
+
+					/* in both cases go to main screen */
+					DataModel_setState(MainState);
+
+				}
+				
+				/* the data is 'N' */
+				else if('N' == data)	
+				{
+					/* set receiving state in next time to temp */
+					ReceivingState = TempReceiving; 	
+
+					DataModel_setState(MainState);
+					/* clear temporary data */
+					memset(strTTemp, 0, 3); 
+				}
 			}break;
 
 			default:
 				break;
 		}	/* end of switch case */
-	vTaskDelay(50);
 	}
 }
 
+/**
+ * @brief receive a calibration table after the 'K' command and reply with
+ * "CAL OK" or "CAL ERR", the frame is binary:
+ * sensor index, CAL_POINTS little endian uint16 values, 8 bit sum of the previous bytes
+ * 
+ */
+void Terminal_Calibration(void)
+{
+	uint8 frame[1 + (CAL_POINTS * 2) + 1];
+	uint16 points[CAL_POINTS];
+	uint8 sum = 0;
+	uint8 k;
+
+	/* the whole frame must arrive without a gap longer than TERMINAL_FRAME_TIMEOUT */
+	if(sizeof(frame) == UART_read(frame, sizeof(frame), TERMINAL_FRAME_TIMEOUT))
+	{
+		for(k = 0; k < (sizeof(frame) - 1); k++)
+		{
+			sum += frame[k];
+		}
+		for(k = 0; k < CAL_POINTS; k++)
+		{
+			points[k] = frame[1 + (2 * k)] | ((uint16)frame[2 + (2 * k)] << 8);
+		}
+
+		if((sum == frame[sizeof(frame) - 1]) && (E_OK == Calibration_setTable(frame[0], points)))
+		{
+			UART_sendString("CAL OK\r\n");
+			return;
+		}
+	}
+
+	UART_sendString("CAL ERR\r\n");
+}
+
+/**
+ * @brief receive the control mode and gains of an actuator after the 'P' command
+ * and reply with "PID OK" or "PID ERR", the frame is binary:
+ * actuator index, mode, little endian uint16 Kp, Ki, Kd, 8 bit sum of the previous bytes
+ * 
+ */
+void Terminal_Tuning(void)
+{
+	uint8 frame[2 + (3 * 2) + 1];
+	Control_Tuning_t tuning;
+	uint8 sum = 0;
+	uint8 k;
+
+	if(sizeof(frame) == UART_read(frame, sizeof(frame), TERMINAL_FRAME_TIMEOUT))
+	{
+		for(k = 0; k < (sizeof(frame) - 1); k++)
+		{
+			sum += frame[k];
+		}
+		tuning.Mode = frame[1];
+		tuning.Kp = frame[2] | ((uint16)frame[3] << 8);
+		tuning.Ki = frame[4] | ((uint16)frame[5] << 8);
+		tuning.Kd = frame[6] | ((uint16)frame[7] << 8);
+
+		if((sum == frame[sizeof(frame) - 1]) && (E_OK == Control_setTuning(frame[0], &tuning)))
+		{
+			/* let T_SysCheck pick up the new mode now */
+			xTaskNotifyGive(thSysCheck);
+			UART_sendString("PID OK\r\n");
+			return;
+		}
+	}
+
+	UART_sendString("PID ERR\r\n");
+}
+
+/**
+ * @brief send a little endian uint32 of a binary reply
+ * 
+ * @param value value to send
+ * @param sum 8 bit sum of the bytes sent before
+ * @return uint8 sum including the sent bytes
+ */
+static uint8 Terminal_sendWord(uint32 value, uint8 sum)
+{
+	uint8 k;
+
+	for(k = 0; k < 4; k++)
+	{
+		UART_sendByte((uint8)value);
+		sum += (uint8)value;
+		value >>= 8;
+	}
+
+	return sum;
+}
+
+/**
+ * @brief reply to the 'R' command with the run time of each task, the frame is binary:
+ * 'R', number of tasks, little endian uint32 run time counter, then for each task
+ * its name in configMAX_TASK_NAME_LEN bytes (zero padded) and its little endian
+ * uint32 run time, 8 bit sum of the bytes after 'R'
+ * 
+ * the times are in timer 1 counts (8 us) since the start, the host takes two dumps
+ * and divides the difference of each task by the difference of the counter
+ * 
+ */
+void Terminal_RunStats(void)
+{
+	const TaskHandle_t tasks[] = {thDisplay, thSensing, thTerminal, thSysCheck, thControl, (TaskHandle_t)&T_IdleTCB};
+	const char * name;
+	uint8 sum = sizeof(tasks) / sizeof(tasks[0]);
+	uint8 k;
+	uint8 i;
+
+	/* this task sleeps each time the uart is full and the idle hook would send
+	 * trace frames in the middle of the binary reply */
+	Trace_pause();
+
+	UART_sendByte('R');
+	UART_sendByte(sum);
+	sum = Terminal_sendWord(portGET_RUN_TIME_COUNTER_VALUE(), sum);
+
+	for(k = 0; k < (sizeof(tasks) / sizeof(tasks[0])); k++)
+	{
+		name = pcTaskGetTaskName(tasks[k]);
+
+		for(i = 0; i < configMAX_TASK_NAME_LEN; i++)
+		{
+			/* zeros after the end of the name */
+			if('\0' == *name)
+			{
+				UART_sendByte(0);
+			}
+			else
+			{
+				UART_sendByte(*name);
+				sum += *name;
+				name++;
+			}
+		}
+
+		sum = Terminal_sendWord(ulTaskGetRunTimeCounter(tasks[k]), sum);
+	}
+
+	UART_sendByte(sum);
+
+	Trace_resume();
+}
+
+/**
+ * @brief send the lcd bus transfers after the 'L' command, one text line:
+ * "LCD flushes commands data last glyphs", last is the number of transfers
+ * of the last screen update, glyphs the number of glyphs sent to the CGRAM
+ * 
+ */
+void Terminal_LcdStats(void)
+{
+	LCD_Stats_t stats;
+	uint16 values[5];
+	char buff[FORMAT_U16_DIGITS + 1];
+	uint8 k;
+
+	LCD_getStats(&stats);
+	values[0] = stats.Flushes;
+	values[1] = stats.Commands;
+	values[2] = stats.Data;
+	values[3] = stats.Last;
+	values[4] = stats.Glyphs;
+
+	UART_sendString("LCD");
+	for(k = 0; k < 5; k++)
+	{
+		UART_sendByte(' ');
+		buff[Format_u16(values[k], buff, 0)] = '\0';
+		UART_sendString(buff);
+	}
+	UART_sendString("\r\n");
+}
+
 /**
  * @brief reading sensors data task
  * 
@@ -344,254 +613,243 @@ void T_Terminal(void* pvParam)
  */
 void T_Sensing(void* pvParam)
 {
-	uint8 tempValue = 0;
-	uint8 humiValue = 0;
+	uint16 tempValue = 0;
+	uint16 humiValue = 0;
+	SensorData_t data;
+
+	/* the ADC keeps sampling all sensors in the background */
+	Sensors_startScan();
 
 	while(1)
 	{
+		/* sleep until a new filtered reading is published (about every 500 ms) */
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		DataModel_getSensorData(&data);
+
+		/* the readings are kept in 8 bits, a calibration table can give more */
 		if(E_OK == TEMP_u16_Read(&tempValue))
 		{
-			if(  SFS.SensorData.TempData != tempValue )
-			{
-				SFS.SensorData.TempData= tempValue;
-				/* give semaphore to system check */
-				xSemaphoreGive(bsCheck);
-				xEventGroupSetBits(egDisplay,E_TUpdated);
-			}
+			data.TempData = (tempValue > 0xFF) ? 0xFF : (uint8)tempValue;
 		}
 		if(E_OK == Humi_u16_Read(&humiValue))
 		{
-			if ( SFS.SensorData.HumiData!= humiValue )
-			{
-				SFS.SensorData.HumiData = humiValue;
-				/* give semaphore to system check */
-				xSemaphoreGive(bsCheck);
-				xEventGroupSetBits(egDisplay,E_HUpdated);
-			}
+			data.HumiData = (humiValue > 0xFF) ? 0xFF : (uint8)humiValue;
 		}
-		vTaskDelay(500);
+
+		/* both readings are published together, a change wakes up system
+		 * check and the display */
+		DataModel_setSensorData(&data);
+	}
+}
+
+/**
+ * @brief called from the ADC interrupt when new filtered sensor readings are ready
+ * 
+ */
+void Sensors_ScanDone(void)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	/* wake up T_Sensing */
+	vTaskNotifyGiveFromISR(thSensing, &xHigherPriorityTaskWoken);
+	if(pdFALSE != xHigherPriorityTaskWoken)
+	{
+		taskYIELD();
 	}
 }
 
 /**
  * @brief Display task
  * 
+ * the notification value holds the changed data model fields (DM_ bits) and
+ * E_Next, the screen layouts and the renderer are in screen.c, the task also
+ * wakes up every TREND_PERIOD to add the readings to the trends
+ * 
  * @param pvParam 
  */
 void T_Display(void* pvParam)
 {
+	uint32_t ulDisplayBits;
+	Screen_Data_t data;
+	const Screen_t * pScreen = &Screen_Main;
+	TickType_t xNextSample;
+	TickType_t xNow;
+	TickType_t xWait;
+	TickType_t xLate;
+	uint8 sampled;
+
+	Trend_init(&TempTrend, SCREEN_TEMP_TREND_GLYPH);
+	Trend_init(&HumiTrend, SCREEN_HUMI_TREND_GLYPH);
+
+	/* the empty trends, the first reading is taken a period after the start */
+	DataModel_getThreshold(&data.Threshold);
+	Trend_draw(&TempTrend, data.Threshold.TempT);
+	Trend_draw(&HumiTrend, data.Threshold.HumiT);
+	xNextSample = xTaskGetTickCount() + TREND_PERIOD;
+
 	while(1)
 	{
-		ebDisplayBits = xEventGroupWaitBits(egDisplay,E_DISPLAYMASK,1,0,portMAX_DELAY);
-
-		if( (ebDisplayBits & E_MainScreen) == E_MainScreen)
-		{					
-			if( MainState == SFS.SystemState )
-			{
-				LCD_clearScreen();
-				LCD_displayString(LCD_MAIN_SCREEN_L1);
-
-				LCD_goToRowColumn(0,LCD_TEMP_COL);
-				LCD_displayString("   ");
-				LCD_goToRowColumn(0,LCD_TEMP_COL);
-				LCD_intgerToString(SFS.SensorData.TempData);
-
-				LCD_goToRowColumn(0,LCD_HUMI_COL);
-				LCD_displayString("   ");
-				LCD_goToRowColumn(0,LCD_HUMI_COL);
-				LCD_intgerToString(SFS.SensorData.HumiData);
-
-				LCD_goToRowColumn(1,0);
-				LCD_displayString(LCD_MAIN_SCREEN_L2);
-
-				LCD_goToRowColumn(1,LCD_TEMP_COL);
-				LCD_displayString("   ");
-				LCD_goToRowColumn(1,LCD_TEMP_COL);
-				LCD_intgerToString(SFS.SensorThreshold.TempT);
-
-				LCD_goToRowColumn(1,LCD_HUMI_COL);
-				LCD_displayString("   ");
-				LCD_goToRowColumn(1,LCD_HUMI_COL);
-				LCD_intgerToString(SFS.SensorThreshold.HumiT);
-
-				LCD_goToRowColumn(2,0);
-				LCD_displayString(LCD_MAIN_SCREEN_L3);
-							
-				if(Motors_State.Water_Pump == ON)
-				{
-					LCD_goToRowColumn(2,LCD_PUMP_COL);
-					LCD_displayString("   ");
-					LCD_goToRowColumn(2,LCD_PUMP_COL);
-					LCD_displayString("ON");
-				}
-				else
-				{
-					LCD_goToRowColumn(2,LCD_PUMP_COL);
-					LCD_displayString("   ");
-					LCD_goToRowColumn(2,LCD_PUMP_COL);
-					LCD_displayString("OFF");
-				}
-
-				if(Motors_State.Heater == ON)
-				{
-					LCD_goToRowColumn(2,LCD_HEATER_COL);
-					LCD_displayString("   ");
-					LCD_goToRowColumn(2,LCD_HEATER_COL);
-					LCD_displayString("ON");
-				}
-				else
-				{
-					LCD_goToRowColumn(2,LCD_HEATER_COL);
-					LCD_displayString("   ");
-					LCD_goToRowColumn(2,LCD_HEATER_COL);
-					LCD_displayString("OFF");
-				}
-
-				if(Motors_State.Cooler == ON)
-				{
-					LCD_goToRowColumn(2,LCD_COOLER_COL);
-					LCD_displayString("   ");
-					LCD_goToRowColumn(2,LCD_COOLER_COL);
-					LCD_displayString("ON");
-				}
-				else
-				{
-					LCD_goToRowColumn(2,LCD_COOLER_COL);
-					LCD_displayString("   ");
-					LCD_goToRowColumn(2,LCD_COOLER_COL);
-					LCD_displayString("OFF");
-				}
-										
-				LCD_goToRowColumn(3,0);
-				LCD_displayString(LCD_MAIN_SCREEN_L4);
-							
-				} /*end of if MainState*/
-						
-			}
+		/* woken up by the notifications or when the next trend reading is due,
+		 * xNextSample is never more than a period ahead */
+		xNow = xTaskGetTickCount();
+		xWait = xNextSample - xNow;
+		if(xWait > TREND_PERIOD)
+		{
+			/* already due */
+			xWait = 0;
+		}
 
-			if( (ebDisplayBits & E_ConfigScreen) == E_ConfigScreen)
+		ulDisplayBits = 0;
+		xTaskNotifyWait(0, E_DISPLAYMASK, &ulDisplayBits, xWait);
+
+		/* one copy of each data group for the whole screen update */
+		DataModel_getSensorData(&data.Sensors);
+		DataModel_getThreshold(&data.Threshold);
+		DataModel_getMotors(&data.Motors);
+
+		/* the glyphs change the trend cells without writing them, the driver
+		 * sends only the glyphs whose bitmap changed */
+		sampled = 0;
+		xNow = xTaskGetTickCount();
+		xLate = xNow - xNextSample;
+		/* not due yet when xNextSample is 1 to TREND_PERIOD ticks ahead */
+		if(xLate < (TickType_t)(0 - TREND_PERIOD))
+		{
+			Trend_add(&TempTrend, data.Sensors.TempData);
+			Trend_add(&HumiTrend, data.Sensors.HumiData);
+			if(xLate >= TREND_PERIOD)
 			{
-				if(ConfigState == SFS.SystemState)
-				{
-					LCD_clearScreen();
-					LCD_displayString(LCD_CONFIG_SCREEN_L1);
-					LCD_displayString(LCD_CONFIG_SCREEN_L2);
-					LCD_goToRowColumn(3,0);
-					LCD_displayString(LCD_CONFIG_SCREEN_L4);
-
-					LCD_goToRowColumn(0,LCD_CONFIG_COL);
-					LCD_sendCommand(CURSOR_BLINK);
-				}
-
+				/* held up for a period or more, the missed readings are
+				 * dropped and the next one is a period from now, or the wait
+				 * above would stay 0 */
+				xNextSample = xNow + TREND_PERIOD;
 			}
-						
-			if( (ebDisplayBits & E_TTUpdated) == E_TTUpdated)
+			else
 			{
-				if(ConfigState == SFS.SystemState)
-				{
-					LCD_goToRowColumn(0,LCD_CONFIG_COL);
-					LCD_sendCommand(CURSOR_OFF);
-					LCD_intgerToString(SFS.SensorThreshold.TempT);
-				}
+				xNextSample += TREND_PERIOD;
 			}
+			sampled = 1;
+		}
+		if(sampled || (ulDisplayBits & DM_TEMP_T))
+		{
+			Trend_draw(&TempTrend, data.Threshold.TempT);
+		}
+		if(sampled || (ulDisplayBits & DM_HUMI_T))
+		{
+			Trend_draw(&HumiTrend, data.Threshold.HumiT);
+		}
 
-			if( (ebDisplayBits & E_HTUpdated) == E_HTUpdated)
+		if(ulDisplayBits & DM_STATE)
+		{
+			if(MainState == DataModel_getState())
 			{
-				if(ConfigState == SFS.SystemState)
-				{
-					LCD_goToRowColumn(2,LCD_CONFIG_COL);
-					LCD_sendCommand(CURSOR_OFF);
-					LCD_intgerToString(SFS.SensorThreshold.HumiT);
-				}
+				pScreen = &Screen_Main;
+				Screen_draw(pScreen, &data);
+				LCD_setCursorMode(CURSOR_OFF);
 			}
-
-			if( (ebDisplayBits & E_Next) == E_Next)
+			else
 			{
-				if(ConfigState == SFS.SystemState)
-				{
-					LCD_goToRowColumn(2,LCD_CONFIG_COL);
-					LCD_sendCommand(CURSOR_BLINK);
-				}
+				/* the cursor waits on the temperature threshold */
+				pScreen = &Screen_Config;
+				Screen_draw(pScreen, &data);
+				LCD_goToRowColumn(SCREEN_CONFIG_TEMP_ROW, SCREEN_CONFIG_COL);
+				LCD_setCursorMode(CURSOR_BLINK);
 			}
+		}
+		else
+		{
+			Screen_update(pScreen, &data, ulDisplayBits);
 
-			if( (ebDisplayBits & E_TUpdated) == E_TUpdated)
+			/* an accepted threshold stops the cursor until the next field */
+			if((pScreen == &Screen_Config) && (ulDisplayBits & DM_THRESHOLDS))
 			{
-				if(MainState == SFS.SystemState)
-				{
-					LCD_goToRowColumn(0,LCD_TEMP_COL);
-					LCD_displayString("   ");
-					LCD_goToRowColumn(0,LCD_TEMP_COL);
-					LCD_intgerToString(SFS.SensorData.TempData);
-				}
+				LCD_setCursorMode(CURSOR_OFF);
 			}
+		}
 
-			if( (ebDisplayBits & E_HUpdated) == E_HUpdated)
-			{
-				if(MainState == SFS.SystemState)
-				{
-					LCD_goToRowColumn(0,LCD_HUMI_COL);
-					LCD_displayString("   ");
-					LCD_goToRowColumn(0,LCD_HUMI_COL);
-					LCD_intgerToString(SFS.SensorData.HumiData);
-				}
-			}
+		if((ulDisplayBits & E_Next) && (pScreen == &Screen_Config))
+		{
+			LCD_goToRowColumn(SCREEN_CONFIG_HUMI_ROW, SCREEN_CONFIG_COL);
+			LCD_setCursorMode(CURSOR_BLINK);
+		}
+	}
+}
 
-			if(MainState == SFS.SystemState)
-			{
-				if( (ebDisplayBits & E_MotorState) == E_MotorState)
-				{
-					if(Motors_State.Water_Pump == ON)
-					{
-						LCD_goToRowColumn(2,LCD_PUMP_COL);
-						LCD_displayString("   ");
-						LCD_goToRowColumn(2,LCD_PUMP_COL);
-						LCD_displayString("ON");
-					}
-					else
-					{
-						LCD_goToRowColumn(2,LCD_PUMP_COL);
-						LCD_displayString("   ");
-						LCD_goToRowColumn(2,LCD_PUMP_COL);
-						LCD_displayString("OFF");
-					}
+/**
+ * @brief data model callback of the fields on the screen, runs in the writer
+ * task, the changed fields are the T_Display notification bits
+ * 
+ */
+void Display_DataChanged(DataModel_Fields_t changed)
+{
+	xTaskNotify(thDisplay, changed, eSetBits);
+}
 
-					if(Motors_State.Heater == ON)
-					{
-						LCD_goToRowColumn(2,LCD_HEATER_COL);
-						LCD_displayString("   ");
-						LCD_goToRowColumn(2,LCD_HEATER_COL);
-						LCD_displayString("ON");
-					}
-					else
-					{
-						LCD_goToRowColumn(2,LCD_HEATER_COL);
-						LCD_displayString("   ");
-						LCD_goToRowColumn(2,LCD_HEATER_COL);
-						LCD_displayString("OFF");
-					}
+/**
+ * @brief idle hook, sends the lcd frame buffer changes and the recorded trace
+ * events and saves the calibration tables when no task is ready so the lcd
+ * busy waits, the trace and the EEPROM writes never delay the application tasks
+ * 
+ */
+void vApplicationIdleHook(void)
+{
+	LCD_flush();
+	Trace_flush();
+	Calibration_flush();
+}
 
-					if(Motors_State.Cooler == ON)
-					{
-						LCD_goToRowColumn(2,LCD_COOLER_COL);
-						LCD_displayString("   ");
-						LCD_goToRowColumn(2,LCD_COOLER_COL);
-						LCD_displayString("ON");
-					}
-					else
-					{
-						LCD_goToRowColumn(2,LCD_COOLER_COL);
-						LCD_displayString("   ");
-						LCD_goToRowColumn(2,LCD_COOLER_COL);
-						LCD_displayString("OFF");
-					}
-				}
-								
-		}
-	}
+/**
+ * @brief called by the idle task before it sleeps, it stays awake while a
+ * save to EEPROM is in progress so the next byte is written as soon as the
+ * previous one is done
+ * 
+ */
+unsigned char ucApplicationIdleHookBusy(void)
+{
+	return Calibration_isSaving();
 }
 
 /**
- * @brief system initialization */
+ * @brief called by the kernel when a task has written past the end of its
+ * stack, the system state can not be trusted anymore so the actuators are
+ * turned off and the system stops after reporting the task name
+ * 
+ */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char * pcTaskName)
+{
+	(void)xTask;
+
+	portDISABLE_INTERRUPTS();
+
+	CLEAR_BIT(PORTD,WATER_PUMP);
+	CLEAR_BIT(PORTD,HEATER);
+	CLEAR_BIT(PORTD,COOLER);
+
+	/* the UDRE ISR can not run anymore, the report is queued and then sent
+	 * by polling with the bytes still waiting before it */
+	UART_sendString("STACK OVERFLOW ");
+	UART_sendString(pcTaskName);
+	UART_sendString("\r\n");
+	UART_flushPolled();
+
+	while(1){}
+}
+
+/**
+ * @brief gives the kernel the memory of the idle task, called by
+ * vTaskStartScheduler
+ * 
+ */
+void vApplicationGetIdleTaskMemory(StaticTask_t ** ppxIdleTaskTCBBuffer, StackType_t ** ppxIdleTaskStackBuffer, uint16_t * pusIdleTaskStackSize)
+{
+	*ppxIdleTaskTCBBuffer = &T_IdleTCB;
+	*ppxIdleTaskStackBuffer = T_IdleStack;
+	*pusIdleTaskStackSize = T_IDLE_STACK;
+}
+
+/**
+ * @brief system initialization
  * 
  */
 void System_Init(void)
@@ -601,6 +859,10 @@ void System_Init(void)
 
 	/* ADC init */
 	ADC_init();
+	Sensors_init(Sensors_ScanDone);
+
+	/* control engine init */
+	Control_init();
 
 	/* MOTORS  directions */
 	SET_BIT(DDRD,WATER_PUMP);
@@ -612,11 +874,11 @@ void System_Init(void)
 	CLEAR_BIT(PORTD,HEATER);
 	CLEAR_BIT(PORTD,COOLER);
 
-	/*Defaults initialize */
-	SFS.SensorData.TempData = 20;
-	SFS.SensorData.HumiData = 30;
-	SFS.SensorThreshold.TempT = 20;
-	SFS.SensorThreshold.HumiT = 30;
+	/* data model subscribers, T_Control first so the relays change before
+	 * the display shows them */
+	DataModel_subscribe(DM_MOTORS, Actuators_DataChanged);
+	DataModel_subscribe(DM_SENSORS | DM_THRESHOLDS, SysCheck_DataChanged);
+	DataModel_subscribe(DM_SENSORS | DM_THRESHOLDS | DM_MOTORS | DM_STATE, Display_DataChanged);
 
 	/* uart init*/
 	UART_init();
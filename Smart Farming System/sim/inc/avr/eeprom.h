@@ -0,0 +1,32 @@
+/**
+ * @file eeprom.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host simulation stand in of the avr-libc <avr/eeprom.h>, the EEMEM
+ * variables are kept in RAM and saved to the file named by the SFS_SIM_EEPROM
+ * environment variable so they survive a restart like the EEPROM does
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef SIM_AVR_EEPROM_H_
+#define SIM_AVR_EEPROM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* all EEMEM variables are placed together so they are saved as one image */
+#define EEMEM	__attribute__((section("sim_eeprom"), used))
+
+void eeprom_read_block(void * __dst, const void * __src, size_t __n);
+uint8_t eeprom_read_byte(const uint8_t * __p);
+void eeprom_update_block(const void * __src, void * __dst, size_t __n);
+void eeprom_update_byte(uint8_t * __p, uint8_t __value);
+void eeprom_write_byte(uint8_t * __p, uint8_t __value);
+
+/* a write is done when the function returns */
+#define eeprom_is_ready()	1
+
+#endif /* SIM_AVR_EEPROM_H_ */
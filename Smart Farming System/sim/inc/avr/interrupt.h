@@ -0,0 +1,27 @@
+/**
+ * @file interrupt.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host simulation stand in of the avr-libc <avr/interrupt.h>, an ISR is
+ * a plain function installed with vPortSimInstallIsr() and the global interrupt
+ * flag is the one of the simulation port
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef SIM_AVR_INTERRUPT_H_
+#define SIM_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+extern void vPortEnableInterrupts(void);
+extern void vPortDisableInterrupts(void);
+
+#define sei()				vPortEnableInterrupts()
+#define cli()				vPortDisableInterrupts()
+
+#define ISR(vector, ...)	void vector(void); void vector(void)
+
+#endif /* SIM_AVR_INTERRUPT_H_ */
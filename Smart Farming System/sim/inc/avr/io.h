@@ -0,0 +1,126 @@
+/**
+ * @file io.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host simulation stand in of the avr-libc <avr/io.h>, the ATmega32 i/o
+ * ports are plain variables and only the registers used outside the simulated
+ * drivers are given, with the USART registers for the host test of the uart
+ * driver
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef SIM_AVR_IO_H_
+#define SIM_AVR_IO_H_
+
+#include <stdint.h>
+
+/* i/o ports */
+extern volatile uint8_t PORTA, DDRA, PINA;
+extern volatile uint8_t PORTB, DDRB, PINB;
+extern volatile uint8_t PORTC, DDRC, PINC;
+extern volatile uint8_t PORTD, DDRD, PIND;
+
+/* USART, plain variables written and read by the tests in place of the
+ * peripheral, UDR stands for both the receive and the transmit register */
+extern volatile uint8_t UDR, UCSRA, UCSRB, UCSRC, UBRRH, UBRRL;
+
+/* status register, only the I flag is simulated and it can only be read, the
+ * interrupts are enabled and disabled through <avr/interrupt.h> */
+extern uint8_t ucPortSimSREG(void);
+#define SREG			(ucPortSimSREG())
+#define SREG_I			7
+
+/* port bits */
+#define PIN0	0
+#define PIN1	1
+#define PIN2	2
+#define PIN3	3
+#define PIN4	4
+#define PIN5	5
+#define PIN6	6
+#define PIN7	7
+
+#define PA0		0
+#define PA1		1
+#define PA2		2
+#define PA3		3
+#define PA4		4
+#define PA5		5
+#define PA6		6
+#define PA7		7
+
+#define PB0		0
+#define PB1		1
+#define PB2		2
+#define PB3		3
+#define PB4		4
+#define PB5		5
+#define PB6		6
+#define PB7		7
+
+#define PC0		0
+#define PC1		1
+#define PC2		2
+#define PC3		3
+#define PC4		4
+#define PC5		5
+#define PC6		6
+#define PC7		7
+
+#define PD0		0
+#define PD1		1
+#define PD2		2
+#define PD3		3
+#define PD4		4
+#define PD5		5
+#define PD6		6
+#define PD7		7
+
+/* USART bits */
+#define MPCM	0
+#define U2X		1
+#define PE		2
+#define DOR		3
+#define FE		4
+#define UDRE	5
+#define TXC		6
+#define RXC		7
+
+#define TXB8	0
+#define RXB8	1
+#define UCSZ2	2
+#define TXEN	3
+#define RXEN	4
+#define UDRIE	5
+#define TXCIE	6
+#define RXCIE	7
+
+#define UCPOL	0
+#define UCSZ0	1
+#define UCSZ1	2
+#define USBS	3
+#define UPM0	4
+#define UPM1	5
+#define UMSEL	6
+#define URSEL	7
+
+/* interrupt vectors of the simulated peripherals, the ATmega32 numbers */
+#define TIMER1_COMPA_vect_num	7
+#define TIMER1_COMPA_vect		__vector_7
+#define USART_RXC_vect_num		13
+#define USART_RXC_vect			__vector_13
+#define USART_UDRE_vect_num		14
+#define USART_UDRE_vect			__vector_14
+#define ADC_vect_num			16
+#define ADC_vect				__vector_16
+
+/* the service routines are installed by their drivers with vPortSimInstallIsr() */
+void TIMER1_COMPA_vect(void);
+void USART_RXC_vect(void);
+void USART_UDRE_vect(void);
+void ADC_vect(void);
+
+#endif /* SIM_AVR_IO_H_ */
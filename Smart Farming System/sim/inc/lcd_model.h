@@ -0,0 +1,66 @@
+/**
+ * @file lcd_model.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host model of the HD44780 behind the lcd driver header file
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * the driver (src/ECU/lcd.c) is built as it is: LCD_DELAY_NS() of lcd_timing.h
+ * calls LCD_simWait(), which moves the bus clock of the model by the wait and
+ * latches the data port on the falling edge of E like the lcd does. The model
+ * is busy for the execution time of each byte it takes and answers the busy
+ * flag reads from the bus clock, so the clock is the time the driver spends
+ * on the bus (the instructions between the waits are not counted)
+ *
+ */
+
+#ifndef LCD_MODEL_H_
+#define LCD_MODEL_H_
+
+#include <stdint.h>
+#include "std_types.h"
+#include "lcd.h"
+
+/**
+ * @brief state of the model lcd
+ *
+ */
+typedef struct
+{
+	/* display data ram, two lines of 40 at 0x00 and 0x40, and character ram */
+	uint8 Ddram[0x80];
+	uint8 Cgram[LCD_GLYPHS * LCD_GLYPH_ROWS];
+
+	/* address counter and the ram it points to */
+	uint8 Address;
+	uint8 InCgram;
+
+	/* cursor mode of the last display control command */
+	uint8 CursorMode;
+
+	/* bus clock and the time the lcd is busy until, in ns */
+	uint64_t TimeNs;
+	uint64_t BusyUntilNs;
+
+	/* bytes taken, and the ones written while the lcd was still busy */
+	uint32 BusWrites;
+	uint32 BusyWrites;
+
+	/* changes since the screen or the glyphs were last shown */
+	uint8 ScreenChanged;
+	uint8 GlyphsChanged;
+} LCD_Model_t;
+
+extern LCD_Model_t LCD_Model;
+
+/**
+ * @brief time passing without a bus wait of the driver (the _delay_us() and
+ * _delay_ms() busy waits), for the host programs that count the time
+ *
+ * @param ns time in ns
+ */
+void LCD_modelDelay(uint32 ns);
+
+#endif /* LCD_MODEL_H_ */
@@ -0,0 +1,46 @@
+/**
+ * @file atomic.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host simulation stand in of the avr-libc <util/atomic.h>, the blocks
+ * disable the interrupts of the simulation port
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef SIM_UTIL_ATOMIC_H_
+#define SIM_UTIL_ATOMIC_H_
+
+#include <stdint.h>
+#include <avr/interrupt.h>
+
+static __inline__ uint8_t __iCliRetVal(void)
+{
+	uint8_t sreg = SREG;
+
+	cli();
+	return sreg;
+}
+
+static __inline__ void __iRestore(const uint8_t * __s)
+{
+	if(*__s & (1 << SREG_I))
+	{
+		sei();
+	}
+}
+
+static __inline__ void __iSeiParam(const uint8_t * __s)
+{
+	(void)__s;
+	sei();
+}
+
+#define ATOMIC_RESTORESTATE		uint8_t sreg_save __attribute__((__cleanup__(__iRestore))) = __iCliRetVal()
+#define ATOMIC_FORCEON			uint8_t sreg_save __attribute__((__cleanup__(__iSeiParam))) = (cli(), 0)
+
+#define ATOMIC_BLOCK(type)		for(type, __ToDo = 1; __ToDo; __ToDo = 0)
+
+#endif /* SIM_UTIL_ATOMIC_H_ */
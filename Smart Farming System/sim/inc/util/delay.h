@@ -0,0 +1,23 @@
+/**
+ * @file delay.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host simulation stand in of the avr-libc <util/delay.h>, the busy
+ * waits hold the simulated CPU for the simulated time
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#ifndef SIM_UTIL_DELAY_H_
+#define SIM_UTIL_DELAY_H_
+
+#include <stdint.h>
+
+extern void vPortSimDelayUs(uint32_t ulMicroseconds);
+
+#define _delay_us(us)		vPortSimDelayUs((uint32_t)(us))
+#define _delay_ms(ms)		vPortSimDelayUs((uint32_t)(ms) * 1000UL)
+
+#endif /* SIM_UTIL_DELAY_H_ */
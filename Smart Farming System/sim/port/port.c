@@ -0,0 +1,588 @@
+/*
+ * Host simulation port of the Smart Farming System.
+ *
+ * 1 tab == 4 spaces!
+ */
+
+/*
+ * Each task runs in its own pthread, the thread of the task in pxCurrentTCB
+ * is the only one executing and a context switch hands the CPU to the thread
+ * of the new task and waits until the old one is selected again.
+ *
+ * The peripherals (the tick timer here, the ADC and the UART in sim/src) are
+ * host threads that raise interrupt vectors.  A raised vector is served by the
+ * running thread the next time it enables interrupts, which the kernel does at
+ * the end of every critical section, or right away when it sleeps in the idle
+ * task.  An interrupt that yields switches the CPU from inside the ISR, as on
+ * the target, and the ISR ends when the interrupted task runs again.  Code that
+ * loops without a kernel call or an interrupt enable is never interrupted.
+ *
+ * The task stacks given to the kernel only hold the thread of the task, so
+ * the stack high water marks and the overflow check mean nothing here.
+ *
+ * Environment variables:
+ * SFS_SIM_SPEED	simulated time / host time, 10 runs the 1 ms tick every
+ *					100 us (default 1)
+ * SFS_SIM_SECONDS	simulated seconds after which vTaskStartScheduler()
+ *					returns and main() ends (default 0, runs for ever)
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*-----------------------------------------------------------
+ * Implementation of functions defined in portable.h for the host simulation.
+ *----------------------------------------------------------*/
+
+/* Max number of tasks, including the idle task. */
+#define portSIM_MAX_TASKS						16
+
+/* Vector of the tick, timer 1 compare match A as on the target. */
+#define portSIM_TICK_VECTOR						7
+
+/* Simulated microseconds in one tick and in one timer 1 count. */
+#define portSIM_US_PER_TICK						( 1000000UL / configTICK_RATE_HZ )
+#define portSIM_US_PER_COUNT					8UL
+
+/* Host thread stack, the application stack sizes are far too small for it. */
+#define portSIM_THREAD_STACK					( 64UL * 1024UL )
+
+/*-----------------------------------------------------------*/
+
+/* Thread of a task, with the interrupt state the task had when it was
+switched out (the AVR port keeps it in SREG on the task stack). */
+typedef struct
+{
+	pthread_t xThread;
+	pthread_cond_t xResume;
+	TaskFunction_t pxCode;
+	void *pvParameters;
+	UBaseType_t uxCriticalNesting;
+	BaseType_t xInterruptsEnabled;
+	BaseType_t xEnabledBeforeCritical;
+} SimThread_t;
+
+/* We require the address of the pxCurrentTCB variable, but don't want to know
+any details of its type. */
+typedef void TCB_t;
+extern volatile TCB_t * volatile pxCurrentTCB;
+
+static SimThread_t xThreads[ portSIM_MAX_TASKS ];
+static UBaseType_t uxThreadCount = 0;
+
+/* Thread allowed to execute, changed with xCpuLock held. */
+static pthread_mutex_t xCpuLock = PTHREAD_MUTEX_INITIALIZER;
+static SimThread_t * volatile pxRunningThread = NULL;
+
+/* Interrupt state of the running thread, the "registers" of the CPU.  Interrupts
+are disabled from the reset until the first task starts. */
+static UBaseType_t uxCriticalNesting = 0;
+static BaseType_t xInterruptsEnabled = pdFALSE;
+static BaseType_t xEnabledBeforeCritical = pdFALSE;
+
+/* Raised vectors, one bit each, and their service routines. */
+static pthread_mutex_t xIrqLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xIrqRaised = PTHREAD_COND_INITIALIZER;
+static volatile uint32_t ulPendingVectors = 0;
+static portSIM_ISR pxIsrTable[ portSIM_VECTORS ];
+
+#if configUSE_TICKLESS_IDLE == 1
+
+	/* Ticks the idle task asked to suppress and the ticks that passed without
+	being raised, both guarded by xIrqLock. */
+	static TickType_t xSuppressedTicks = 0;
+	static TickType_t xSleptTicks = 0;
+
+#endif /* configUSE_TICKLESS_IDLE */
+
+/* Host time of the start and the speed of the simulation. */
+static struct timespec xStartTime;
+static uint32_t ulSpeed = 1;
+static uint32_t ulRunSeconds = 0;
+
+/*-----------------------------------------------------------*/
+
+/*
+ * Read the environment and take the start time, before main().
+ */
+static void prvSimInit( void ) __attribute__ ( ( constructor ) );
+
+/*
+ * Host nanoseconds since the start.
+ */
+static uint64_t prvHostNanoseconds( void );
+
+/*
+ * Thread of the task a TCB belongs to.
+ */
+static SimThread_t *prvThreadOf( volatile TCB_t *pxTCB );
+
+/*
+ * Hand the CPU from the running thread to another one and wait until the
+ * running thread is selected again.
+ */
+static void prvSwitchThread( SimThread_t *pxFrom, SimThread_t *pxTo );
+
+/*
+ * Serve the raised vectors, lowest first, while interrupts are enabled.
+ */
+static void prvServeInterrupts( void );
+
+/*
+ * Start function of the task threads.
+ */
+static void *prvTaskThread( void *pvParameters );
+
+/*
+ * Host thread of timer 1, raises the tick vector every tick period.
+ */
+static void *prvTickThread( void *pvParameters );
+
+/*
+ * Tick ISR.
+ */
+static void prvTickInterrupt( void );
+
+/*-----------------------------------------------------------*/
+
+static void prvSimInit( void )
+{
+const char *pcValue;
+
+	pcValue = getenv( "SFS_SIM_SPEED" );
+	if( ( pcValue != NULL ) && ( atol( pcValue ) > 0 ) )
+	{
+		ulSpeed = ( uint32_t ) atol( pcValue );
+	}
+
+	pcValue = getenv( "SFS_SIM_SECONDS" );
+	if( ( pcValue != NULL ) && ( atol( pcValue ) > 0 ) )
+	{
+		ulRunSeconds = ( uint32_t ) atol( pcValue );
+	}
+
+	clock_gettime( CLOCK_MONOTONIC, &xStartTime );
+}
+/*-----------------------------------------------------------*/
+
+static uint64_t prvHostNanoseconds( void )
+{
+struct timespec xNow;
+
+	clock_gettime( CLOCK_MONOTONIC, &xNow );
+
+	return ( ( uint64_t ) ( xNow.tv_sec - xStartTime.tv_sec ) * 1000000000ULL ) + ( uint64_t ) xNow.tv_nsec - ( uint64_t ) xStartTime.tv_nsec;
+}
+/*-----------------------------------------------------------*/
+
+uint64_t ullPortSimTimeUs( void )
+{
+	return ( prvHostNanoseconds() * ulSpeed ) / 1000ULL;
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimSleepUs( uint32_t ulMicroseconds )
+{
+struct timespec xDelay;
+uint64_t ullNanoseconds;
+
+	ullNanoseconds = ( ( uint64_t ) ulMicroseconds * 1000ULL ) / ulSpeed;
+	xDelay.tv_sec = ( time_t ) ( ullNanoseconds / 1000000000ULL );
+	xDelay.tv_nsec = ( long ) ( ullNanoseconds % 1000000000ULL );
+
+	while( nanosleep( &xDelay, &xDelay ) != 0 )
+	{
+		/* Interrupted by a signal, sleep the rest. */
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimInstallIsr( UBaseType_t uxVector, portSIM_ISR pxIsr )
+{
+	if( uxVector < portSIM_VECTORS )
+	{
+		pxIsrTable[ uxVector ] = pxIsr;
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimRaiseIsr( UBaseType_t uxVector )
+{
+	if( uxVector < portSIM_VECTORS )
+	{
+		pthread_mutex_lock( &xIrqLock );
+		ulPendingVectors |= ( 1UL << uxVector );
+		pthread_cond_signal( &xIrqRaised );
+		pthread_mutex_unlock( &xIrqLock );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void prvServeInterrupts( void )
+{
+UBaseType_t uxVector;
+
+	while( ( xInterruptsEnabled != pdFALSE ) && ( __atomic_load_n( &ulPendingVectors, __ATOMIC_ACQUIRE ) != 0 ) )
+	{
+		pthread_mutex_lock( &xIrqLock );
+		uxVector = ( UBaseType_t ) __builtin_ctz( ulPendingVectors );
+		ulPendingVectors &= ~( 1UL << uxVector );
+		pthread_mutex_unlock( &xIrqLock );
+
+		if( pxIsrTable[ uxVector ] != NULL )
+		{
+			/* The ISR runs with interrupts disabled, if it yields the state is
+			kept with the interrupted task until it runs again. */
+			xInterruptsEnabled = pdFALSE;
+			pxIsrTable[ uxVector ]();
+			xInterruptsEnabled = pdTRUE;
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnterCritical( void )
+{
+	if( uxCriticalNesting == 0 )
+	{
+		xEnabledBeforeCritical = xInterruptsEnabled;
+	}
+	xInterruptsEnabled = pdFALSE;
+	uxCriticalNesting++;
+}
+/*-----------------------------------------------------------*/
+
+void vPortExitCritical( void )
+{
+	if( uxCriticalNesting > 0 )
+	{
+		uxCriticalNesting--;
+		if( ( uxCriticalNesting == 0 ) && ( xEnabledBeforeCritical != pdFALSE ) )
+		{
+			vPortEnableInterrupts();
+		}
+	}
+}
+/*-----------------------------------------------------------*/
+
+void vPortDisableInterrupts( void )
+{
+	xInterruptsEnabled = pdFALSE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEnableInterrupts( void )
+{
+	xInterruptsEnabled = pdTRUE;
+	prvServeInterrupts();
+}
+/*-----------------------------------------------------------*/
+
+uint8_t ucPortSimSREG( void )
+{
+	/* Only the I flag is simulated. */
+	return ( xInterruptsEnabled != pdFALSE ) ? ( uint8_t ) 0x80 : ( uint8_t ) 0x00;
+}
+/*-----------------------------------------------------------*/
+
+void vPortSimDelayUs( uint32_t ulMicroseconds )
+{
+	/* A busy wait of the target, the CPU is held for the whole time. */
+	vPortSimSleepUs( ulMicroseconds );
+}
+/*-----------------------------------------------------------*/
+
+/*
+ * Create the thread of a task.  It waits until the task is selected, the
+ * pointer to it is kept on the top of the task stack where the kernel saves
+ * pxTopOfStack.
+ */
+StackType_t *pxPortInitialiseStack( StackType_t *pxTopOfStack, TaskFunction_t pxCode, void *pvParameters )
+{
+SimThread_t *pxThread;
+pthread_attr_t xAttributes;
+
+	configASSERT( uxThreadCount < portSIM_MAX_TASKS );
+	if( uxThreadCount >= portSIM_MAX_TASKS )
+	{
+		abort();
+	}
+
+	pxThread = &xThreads[ uxThreadCount ];
+	uxThreadCount++;
+
+	pxThread->pxCode = pxCode;
+	pxThread->pvParameters = pvParameters;
+	pxThread->uxCriticalNesting = 0;
+	pxThread->xInterruptsEnabled = pdTRUE;
+	pxThread->xEnabledBeforeCritical = pdFALSE;
+	pthread_cond_init( &pxThread->xResume, NULL );
+
+	pthread_attr_init( &xAttributes );
+	pthread_attr_setstacksize( &xAttributes, portSIM_THREAD_STACK );
+	if( pthread_create( &pxThread->xThread, &xAttributes, prvTaskThread, pxThread ) != 0 )
+	{
+		abort();
+	}
+	pthread_attr_destroy( &xAttributes );
+
+	pxTopOfStack -= sizeof( SimThread_t * );
+	memcpy( pxTopOfStack + 1, &pxThread, sizeof( SimThread_t * ) );
+
+	return pxTopOfStack;
+}
+/*-----------------------------------------------------------*/
+
+static SimThread_t *prvThreadOf( volatile TCB_t *pxTCB )
+{
+StackType_t *pxTopOfStack;
+SimThread_t *pxThread;
+
+	/* pxTopOfStack is the first member of the TCB. */
+	pxTopOfStack = *( StackType_t * volatile * ) pxTCB;
+	memcpy( &pxThread, pxTopOfStack + 1, sizeof( SimThread_t * ) );
+
+	return pxThread;
+}
+/*-----------------------------------------------------------*/
+
+static void prvSwitchThread( SimThread_t *pxFrom, SimThread_t *pxTo )
+{
+	pxFrom->uxCriticalNesting = uxCriticalNesting;
+	pxFrom->xInterruptsEnabled = xInterruptsEnabled;
+	pxFrom->xEnabledBeforeCritical = xEnabledBeforeCritical;
+
+	pthread_mutex_lock( &xCpuLock );
+	pxRunningThread = pxTo;
+	pthread_cond_signal( &pxTo->xResume );
+	while( pxRunningThread != pxFrom )
+	{
+		pthread_cond_wait( &pxFrom->xResume, &xCpuLock );
+	}
+	pthread_mutex_unlock( &xCpuLock );
+
+	uxCriticalNesting = pxFrom->uxCriticalNesting;
+	xInterruptsEnabled = pxFrom->xInterruptsEnabled;
+	xEnabledBeforeCritical = pxFrom->xEnabledBeforeCritical;
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTaskThread( void *pvParameters )
+{
+SimThread_t *pxThread = ( SimThread_t * ) pvParameters;
+
+	pthread_mutex_lock( &xCpuLock );
+	while( pxRunningThread != pxThread )
+	{
+		pthread_cond_wait( &pxThread->xResume, &xCpuLock );
+	}
+	pthread_mutex_unlock( &xCpuLock );
+
+	/* Start tasks with interrupts enabled, any vector raised meanwhile is
+	served first. */
+	uxCriticalNesting = pxThread->uxCriticalNesting;
+	xEnabledBeforeCritical = pxThread->xEnabledBeforeCritical;
+	vPortEnableInterrupts();
+
+	pxThread->pxCode( pxThread->pvParameters );
+
+	/* Tasks must not return. */
+	abort();
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+BaseType_t xPortStartScheduler( void )
+{
+pthread_t xTickThread;
+struct timespec xEnd;
+
+	/* Setup the hardware to generate the tick. */
+	vPortSimInstallIsr( portSIM_TICK_VECTOR, prvTickInterrupt );
+	if( pthread_create( &xTickThread, NULL, prvTickThread, NULL ) != 0 )
+	{
+		return pdFALSE;
+	}
+
+	/* Start the first task, the main thread is not a task, it only ends the
+	simulation. */
+	pthread_mutex_lock( &xCpuLock );
+	pxRunningThread = prvThreadOf( pxCurrentTCB );
+	pthread_cond_signal( &pxRunningThread->xResume );
+	pthread_mutex_unlock( &xCpuLock );
+
+	if( ulRunSeconds == 0 )
+	{
+		for( ;; )
+		{
+			pause();
+		}
+	}
+
+	/* Host time of the end, the start time plus the simulated seconds. */
+	xEnd = xStartTime;
+	xEnd.tv_sec += ( time_t ) ( ulRunSeconds / ulSpeed );
+	xEnd.tv_nsec += ( long ) ( ( ( uint64_t ) ( ulRunSeconds % ulSpeed ) * 1000000000ULL ) / ulSpeed );
+	if( xEnd.tv_nsec >= 1000000000L )
+	{
+		xEnd.tv_sec++;
+		xEnd.tv_nsec -= 1000000000L;
+	}
+	while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xEnd, NULL ) == EINTR )
+	{
+		/* Interrupted by a signal, sleep the rest. */
+	}
+
+	/* main() returns and the process ends with the task threads. */
+	return pdTRUE;
+}
+/*-----------------------------------------------------------*/
+
+void vPortEndScheduler( void )
+{
+	exit( EXIT_SUCCESS );
+}
+/*-----------------------------------------------------------*/
+
+void vPortYield( void )
+{
+SimThread_t *pxFrom;
+SimThread_t *pxTo;
+
+	pxFrom = prvThreadOf( pxCurrentTCB );
+	vTaskSwitchContext();
+	pxTo = prvThreadOf( pxCurrentTCB );
+
+	if( pxTo != pxFrom )
+	{
+		prvSwitchThread( pxFrom, pxTo );
+	}
+}
+/*-----------------------------------------------------------*/
+
+static void *prvTickThread( void *pvParameters )
+{
+struct timespec xNext;
+uint64_t ullPeriod;
+
+	( void ) pvParameters;
+
+	/* Absolute deadlines so the tick does not drift, a late tick is only
+	raised once as on the target. */
+	ullPeriod = ( ( uint64_t ) portSIM_US_PER_TICK * 1000ULL ) / ulSpeed;
+	clock_gettime( CLOCK_MONOTONIC, &xNext );
+
+	for( ;; )
+	{
+		xNext.tv_nsec += ( long ) ullPeriod;
+		while( xNext.tv_nsec >= 1000000000L )
+		{
+			xNext.tv_sec++;
+			xNext.tv_nsec -= 1000000000L;
+		}
+		while( clock_nanosleep( CLOCK_MONOTONIC, TIMER_ABSTIME, &xNext, NULL ) == EINTR )
+		{
+			/* Interrupted by a signal, sleep the rest. */
+		}
+
+		#if configUSE_TICKLESS_IDLE == 1
+		{
+			pthread_mutex_lock( &xIrqLock );
+			if( ( xSuppressedTicks != 0 ) && ( xSleptTicks < ( TickType_t ) ( xSuppressedTicks - 1 ) ) )
+			{
+				/* The idle task sleeps, the tick is counted but not raised. */
+				xSleptTicks++;
+				pthread_mutex_unlock( &xIrqLock );
+				continue;
+			}
+			pthread_mutex_unlock( &xIrqLock );
+		}
+		#endif /* configUSE_TICKLESS_IDLE */
+
+		vPortSimRaiseIsr( portSIM_TICK_VECTOR );
+	}
+
+	return NULL;
+}
+/*-----------------------------------------------------------*/
+
+static void prvTickInterrupt( void )
+{
+	if( xTaskIncrementTick() != pdFALSE )
+	{
+		vPortYield();
+	}
+}
+/*-----------------------------------------------------------*/
+
+#if configUSE_TICKLESS_IDLE == 1
+
+	/*
+	 * Called by the idle task, with the scheduler suspended, when no task
+	 * needs to run for at least xExpectedIdleTime ticks.  The thread sleeps on
+	 * the host until a vector is raised, the tick thread counts the ticks that
+	 * pass meanwhile and raises the tick at the end of the idle time.
+	 */
+	void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime )
+	{
+	TickType_t xStepTicks;
+
+		portDISABLE_INTERRUPTS();
+
+		/* Don't sleep if a task was readied, a yield was pended or a vector is
+		already waiting to be served. */
+		if( ( eTaskConfirmSleepModeStatus() == eAbortSleep ) || ( __atomic_load_n( &ulPendingVectors, __ATOMIC_ACQUIRE ) != 0 ) )
+		{
+			portENABLE_INTERRUPTS();
+			return;
+		}
+
+		pthread_mutex_lock( &xIrqLock );
+		xSuppressedTicks = xExpectedIdleTime;
+		xSleptTicks = 0;
+
+		configPRE_SLEEP_PROCESSING( xExpectedIdleTime );
+		if( xExpectedIdleTime > 0 )
+		{
+			while( ulPendingVectors == 0 )
+			{
+				pthread_cond_wait( &xIrqRaised, &xIrqLock );
+			}
+		}
+		configPOST_SLEEP_PROCESSING( xExpectedIdleTime );
+
+		xStepTicks = xSleptTicks;
+		xSuppressedTicks = 0;
+		xSleptTicks = 0;
+		pthread_mutex_unlock( &xIrqLock );
+
+		/* The raised tick, if any, counts the last tick of the idle time. */
+		if( xStepTicks > 0 )
+		{
+			vTaskStepTick( xStepTicks );
+		}
+
+		/* Serve the vector that ended the sleep. */
+		portENABLE_INTERRUPTS();
+	}
+
+#endif /* configUSE_TICKLESS_IDLE */
+/*-----------------------------------------------------------*/
+
+#if configGENERATE_RUN_TIME_STATS == 1
+
+	uint32_t ulPortGetRunTimeCounter( void )
+	{
+		return ( uint32_t ) ( ullPortSimTimeUs() / portSIM_US_PER_COUNT );
+	}
+
+#endif /* configGENERATE_RUN_TIME_STATS */
+/*-----------------------------------------------------------*/
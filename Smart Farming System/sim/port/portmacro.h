@@ -0,0 +1,148 @@
+/*
+ * Host simulation port of the Smart Farming System.
+ *
+ * Selected with SFS_SIM_PORT (see FreeRTOS/Inc/portable.h), the kernel, the
+ * application and the ECU drivers are built for a Linux workstation from the
+ * target sources and only the port and the MCAL drivers are replaced, the lcd
+ * driver runs over a model of its bus (sim/src/ECU/lcd.c).
+ *
+ * 1 tab == 4 spaces!
+ */
+
+#ifndef PORTMACRO_H
+#define PORTMACRO_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*-----------------------------------------------------------
+ * Port specific definitions.
+ *
+ * Each task runs in its own pthread and only the thread of the running task
+ * is allowed to execute, so the kernel sees a single CPU.  Interrupts are
+ * raised by host threads playing the peripherals and are taken by the running
+ * thread when it enables interrupts, see port.c.
+ *-----------------------------------------------------------
+ */
+
+/* Type definitions.  The stack is still counted in bytes as the task stack
+sizes of the application are given in bytes. */
+#define portCHAR		char
+#define portFLOAT		float
+#define portDOUBLE		double
+#define portLONG		long
+#define portSHORT		short
+#define portSTACK_TYPE	uint8_t
+#define portBASE_TYPE	long
+
+typedef portSTACK_TYPE StackType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#if( configUSE_16_BIT_TICKS == 1 )
+	typedef uint16_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffff
+#else
+	typedef uint32_t TickType_t;
+	#define portMAX_DELAY ( TickType_t ) 0xffffffffUL
+#endif
+
+#define portPOINTER_SIZE_TYPE	uintptr_t
+/*-----------------------------------------------------------*/
+
+/* Critical section management. */
+extern void vPortEnterCritical( void );
+extern void vPortExitCritical( void );
+extern void vPortDisableInterrupts( void );
+extern void vPortEnableInterrupts( void );
+
+#define portENTER_CRITICAL()		vPortEnterCritical()
+#define portEXIT_CRITICAL()			vPortExitCritical()
+#define portDISABLE_INTERRUPTS()	vPortDisableInterrupts()
+#define portENABLE_INTERRUPTS()		vPortEnableInterrupts()
+/*-----------------------------------------------------------*/
+
+/* Architecture specifics. */
+#define portSTACK_GROWTH			( -1 )
+#define portTICK_PERIOD_MS			( ( TickType_t ) 1000 / configTICK_RATE_HZ )
+/* The mask of portable.h for 8 is unsigned int and would clear the high half of
+a 64 bit stack address, nothing is aligned on the task stacks anyway. */
+#define portBYTE_ALIGNMENT			4
+#define portNOP()
+/*-----------------------------------------------------------*/
+
+/* Kernel utilities. */
+extern void vPortYield( void );
+#define portYIELD()					vPortYield()
+/*-----------------------------------------------------------*/
+
+/* Tickless idle, the idle thread sleeps on the host until an interrupt is
+raised and the tick thread counts the suppressed ticks. */
+#if ( configUSE_TICKLESS_IDLE == 1 )
+	extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
+	#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime ) vPortSuppressTicksAndSleep( xExpectedIdleTime )
+#endif
+/*-----------------------------------------------------------*/
+
+/* Run time statistics, counted in the 8 us timer 1 counts of the target from
+the simulated time so the host tools read both the same way. */
+#if ( configGENERATE_RUN_TIME_STATS == 1 )
+	extern uint32_t ulPortGetRunTimeCounter( void );
+	#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+	#define portGET_RUN_TIME_COUNTER_VALUE() ulPortGetRunTimeCounter()
+#endif
+/*-----------------------------------------------------------*/
+
+/* Port optimised task selection with the count leading zeros builtin. */
+#if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 1 )
+
+	/* Check the configuration. */
+	#if( configMAX_PRIORITIES > 32 )
+		#error configUSE_PORT_OPTIMISED_TASK_SELECTION can only be set to 1 when configMAX_PRIORITIES is less than or equal to 32.
+	#endif
+
+	/* Store/clear the ready priorities in a bit map. */
+	#define portRECORD_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) |= ( 1UL << ( uxPriority ) )
+	#define portRESET_READY_PRIORITY( uxPriority, uxReadyPriorities ) ( uxReadyPriorities ) &= ~( 1UL << ( uxPriority ) )
+
+	/*-----------------------------------------------------------*/
+
+	#define portGET_HIGHEST_PRIORITY( uxTopPriority, uxReadyPriorities ) uxTopPriority = ( 31UL - ( uint32_t ) __builtin_clz( ( uint32_t ) ( uxReadyPriorities ) ) )
+
+#endif /* configUSE_PORT_OPTIMISED_TASK_SELECTION */
+/*-----------------------------------------------------------*/
+
+/* Task function macros as described on the FreeRTOS.org WEB site. */
+#define portTASK_FUNCTION_PROTO( vFunction, pvParameters ) void vFunction( void *pvParameters )
+#define portTASK_FUNCTION( vFunction, pvParameters ) void vFunction( void *pvParameters )
+/*-----------------------------------------------------------*/
+
+/* Simulated hardware, used by the drivers under sim/src. */
+
+/* Interrupt service routine of a simulated vector. */
+typedef void ( *portSIM_ISR )( void );
+
+/* Number of simulated vectors, the numbers are the ATmega32 ones so a lower
+vector is served first as on the target. */
+#define portSIM_VECTORS				21
+
+/* Install the service routine of a vector, before the scheduler starts. */
+extern void vPortSimInstallIsr( UBaseType_t uxVector, portSIM_ISR pxIsr );
+
+/* Raise a vector from any host thread.  Like an AVR interrupt flag it is only
+latched once, it is served when the running task enables interrupts. */
+extern void vPortSimRaiseIsr( UBaseType_t uxVector );
+
+/* Microseconds of simulated time since the start, the host time multiplied by
+the SFS_SIM_SPEED environment variable. */
+extern uint64_t ullPortSimTimeUs( void );
+
+/* Sleep the calling host thread for a simulated time. */
+extern void vPortSimSleepUs( uint32_t ulMicroseconds );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* PORTMACRO_H */
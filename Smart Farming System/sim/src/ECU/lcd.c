@@ -0,0 +1,135 @@
+/**
+ * @file lcd.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host simulation of the lcd screen, the driver (src/ECU/lcd.c) is
+ * built as it is over the HD44780 model (lcd_model.c). The screen of the model
+ * is written to the file named by the SFS_SIM_LCD environment variable ("-"
+ * for stdout) after each LCD_flush() that changed it, the cells showing a
+ * glyph are written 'a' to 'h' and the glyphs are drawn under the screen each
+ * time the CGRAM changes
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "lcd.h"
+#include "lcd_model.h"
+
+/* the driver flush, renamed when src/ECU/lcd.c is built for the simulation */
+void LCD_driverFlush(void);
+
+/* lcd address of the first column in each row */
+static const uint8 LCD_RowAddress[LCD_ROWS] = {0x00, 0x40, 0x14, 0x54};
+
+/* file the screens are written to */
+static FILE * LCD_File = NULL;
+static uint8 LCD_FileOpened = 0;
+
+/**
+ * @brief open the file of the screens the first time
+ *
+ */
+static void LCD_openFile(void)
+{
+	const char * pPath = getenv("SFS_SIM_LCD");
+
+	LCD_FileOpened = 1;
+	if(NULL == pPath)
+	{
+		return;
+	}
+
+	if(('-' == pPath[0]) && ('\0' == pPath[1]))
+	{
+		LCD_File = stdout;
+	}
+	else
+	{
+		LCD_File = fopen(pPath, "w");
+		if(NULL == LCD_File)
+		{
+			perror(pPath);
+		}
+	}
+}
+
+void LCD_flush(void)
+{
+	uint64_t now;
+	uint8 cursorRow = LCD_ROWS;
+	uint8 cursorCol = 0;
+	uint8 row;
+	uint8 col;
+	uint8 index;
+	uint8 data;
+
+	LCD_driverFlush();
+
+	if(!LCD_FileOpened)
+	{
+		LCD_openFile();
+	}
+	if(!LCD_Model.ScreenChanged || (NULL == LCD_File))
+	{
+		return;
+	}
+	LCD_Model.ScreenChanged = 0;
+
+	/* the row and column of a visible cursor */
+	if((LCD_Model.CursorMode != CURSOR_OFF) && !LCD_Model.InCgram)
+	{
+		for(row = 0; row < LCD_ROWS; row++)
+		{
+			if((LCD_Model.Address >= LCD_RowAddress[row]) && (LCD_Model.Address < (LCD_RowAddress[row] + LCD_COLS)))
+			{
+				cursorRow = row;
+				cursorCol = LCD_Model.Address - LCD_RowAddress[row];
+			}
+		}
+	}
+
+	/* time of the screen and bus writes so far, then the rows */
+	now = ullPortSimTimeUs();
+	fprintf(LCD_File, "--- %lu.%03lu s, %lu bus writes ---\n", (unsigned long)(now / 1000000ULL),
+			(unsigned long)((now / 1000ULL) % 1000ULL), (unsigned long)LCD_Model.BusWrites);
+	for(row = 0; row < LCD_ROWS; row++)
+	{
+		fputc('|', LCD_File);
+		for(col = 0; col < LCD_COLS; col++)
+		{
+			data = LCD_Model.Ddram[LCD_RowAddress[row] + col];
+			/* glyph 0-7 at the codes 0-7 and 8-15 */
+			fputc((data < (2 * LCD_GLYPHS)) ? ('a' + (data % LCD_GLYPHS)) : data, LCD_File);
+		}
+		fputc('|', LCD_File);
+		if(row == cursorRow)
+		{
+			fprintf(LCD_File, " <- cursor %u", cursorCol);
+		}
+		fputc('\n', LCD_File);
+	}
+
+	/* the pixel rows of all the glyphs side by side, 'a' to 'h' */
+	if(LCD_Model.GlyphsChanged)
+	{
+		LCD_Model.GlyphsChanged = 0;
+		for(row = 0; row < LCD_GLYPH_ROWS; row++)
+		{
+			for(index = 0; index < LCD_GLYPHS; index++)
+			{
+				fputc(' ', LCD_File);
+				for(col = 0; col < 5; col++)
+				{
+					fputc((LCD_Model.Cgram[(index * LCD_GLYPH_ROWS) + row] & (0x10 >> col)) ? '#' : '.', LCD_File);
+				}
+			}
+			fputc('\n', LCD_File);
+		}
+	}
+	fflush(LCD_File);
+}
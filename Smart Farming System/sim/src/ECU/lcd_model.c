@@ -0,0 +1,149 @@
+/**
+ * @file lcd_model.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host model of the HD44780 behind the lcd driver, see lcd_model.h
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include "string.h"
+#include "lcd_model.h"
+#include "lcd_timing.h"
+
+#if (DATA_BITS_MODE != 8)
+	#error the lcd model takes the 8-bit bus only
+#endif
+
+LCD_Model_t LCD_Model = { .CursorMode = CURSOR_OFF };
+
+/* E at the last wait of the driver, a byte is taken when it falls */
+static uint8 LCD_LastE = 0;
+
+/**
+ * @brief the address that follows in the ram the address counter points to
+ *
+ */
+static uint8 LCD_nextAddress(uint8 address)
+{
+	if(LCD_Model.InCgram)
+	{
+		return (address + 1) & 0x3F;
+	}
+
+	/* 0x27 -> 0x40 and 0x67 -> 0x00 in two line mode */
+	address++;
+	if(0x28 == address)
+	{
+		return 0x40;
+	}
+	if(0x68 == address)
+	{
+		return 0x00;
+	}
+	return address;
+}
+
+/**
+ * @brief a command or data byte written by the driver
+ *
+ */
+static void LCD_busWrite(uint8 rs, uint8 value)
+{
+	uint32 execUs = LCD_T_EXEC_US;
+
+	LCD_Model.BusWrites++;
+	if(LCD_Model.TimeNs < LCD_Model.BusyUntilNs)
+	{
+		LCD_Model.BusyWrites++;
+	}
+
+	if(rs)
+	{
+		if(LCD_Model.InCgram)
+		{
+			LCD_Model.Cgram[LCD_Model.Address] = value & 0x1F;
+			LCD_Model.GlyphsChanged = 1;
+		}
+		else
+		{
+			LCD_Model.Ddram[LCD_Model.Address] = value;
+		}
+		LCD_Model.Address = LCD_nextAddress(LCD_Model.Address);
+		LCD_Model.ScreenChanged = 1;
+	}
+	else if(value & SET_CURSOR_LOCATION)
+	{
+		LCD_Model.Address = value & 0x7F;
+		LCD_Model.InCgram = 0;
+		LCD_Model.ScreenChanged |= (LCD_Model.CursorMode != CURSOR_OFF);
+	}
+	else if(value & SET_CGRAM_ADDRESS)
+	{
+		LCD_Model.Address = value & 0x3F;
+		LCD_Model.InCgram = 1;
+	}
+	else if(value & 0x20)
+	{
+		/* function set, the driver uses the 8-bit 2-line mode */
+	}
+	else if(value & 0x10)
+	{
+		/* cursor or display shift, not sent by the driver */
+	}
+	else if(value & 0x08)
+	{
+		LCD_Model.CursorMode = value;
+		LCD_Model.ScreenChanged = 1;
+	}
+	else if(value & 0x04)
+	{
+		/* entry mode, not sent by the driver, the address counter goes up as
+		 * after the reset */
+	}
+	else if(value & 0x02)
+	{
+		/* return home */
+		LCD_Model.Address = 0;
+		LCD_Model.InCgram = 0;
+		execUs = LCD_T_EXEC_CLEAR_US;
+	}
+	else if(CLEAR_COMMAND == value)
+	{
+		memset(LCD_Model.Ddram, ' ', sizeof(LCD_Model.Ddram));
+		LCD_Model.Address = 0;
+		LCD_Model.InCgram = 0;
+		LCD_Model.ScreenChanged = 1;
+		execUs = LCD_T_EXEC_CLEAR_US;
+	}
+
+	/* busy from the falling edge of E */
+	LCD_Model.BusyUntilNs = LCD_Model.TimeNs + ((uint64_t)execUs * 1000ULL);
+}
+
+void LCD_simWait(uint16 ns)
+{
+	uint8 e = BIT_IS_SET(LCD_CTRL_PORT,E) ? 1 : 0;
+
+	/* the byte is taken when E falls, the wait comes after it */
+	if(BIT_IS_CLEAR(LCD_CTRL_PORT,RW) && LCD_LastE && !e)
+	{
+		LCD_busWrite(BIT_IS_SET(LCD_CTRL_PORT,RS), LCD_DATA_PORT);
+	}
+	LCD_LastE = e;
+
+	LCD_Model.TimeNs += ns;
+
+	if(BIT_IS_SET(LCD_CTRL_PORT,RW))
+	{
+		/* a read, DB7 is the busy flag and DB6-DB0 the address counter */
+		PINC = ((LCD_Model.TimeNs < LCD_Model.BusyUntilNs) ? 0x80 : 0x00) | (LCD_Model.Address & 0x7F);
+	}
+}
+
+void LCD_modelDelay(uint32 ns)
+{
+	LCD_Model.TimeNs += ns;
+}
@@ -0,0 +1,350 @@
+/**
+ * @file adc.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host simulation of the adc driver, the conversions are taken from the
+ * stimulus file named by the SFS_SIM_ADC environment variable and are timed
+ * by a host thread in place of timer0 and the ADC
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * stimulus file, one step per line, '#' starts a comment:
+ *     time_ms value_ch0 [value_ch1 ... value_ch7]
+ * the 10 bit values hold from time_ms (simulated time since the start) until
+ * the next step, channels not given keep their value, without the file all
+ * channels read ADC_SIM_DEFAULT
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <avr/interrupt.h>
+#include <util/atomic.h>
+#include "FreeRTOS.h"
+#include "adc.h"
+
+/* value of the channels without a stimulus */
+#define ADC_SIM_DEFAULT 512
+
+/* number of channels */
+#define ADC_SIM_CHANNELS 8
+
+/* time of a conversion started by ADSC, 13 ADC clocks at 125 kHz */
+#define ADC_SIM_CONVERSION_US 104
+
+/* time between two timer0 triggers of the continuous scan */
+#define ADC_SIM_TRIGGER_US (1000000UL / ADC_TRIGGER_HZ)
+
+/**
+ * @brief one step of the stimulus
+ *
+ */
+typedef struct
+{
+	uint64_t TimeUs;
+	uint16 Values[ADC_SIM_CHANNELS];
+} ADC_Step_t;
+
+static ADC_Step_t * Steps = NULL;
+static uint32 StepCount = 0;
+static uint32 StepIndex = 0;
+
+/* scan configuration */
+static uint8 ScanChannels[ADC_MAX_SCAN_CHANNELS];
+static uint8 ScanCount = 0;
+static ADC_ScanCallback_t ScanCallback = NULL_PTR;
+
+/* index of the channel being converted */
+static volatile uint8 ScanIndex = 0;
+
+/* oversampling accumulators and number of completed passes over the channels */
+static uint16 Sums[ADC_MAX_SCAN_CHANNELS];
+static uint8 Passes = 0;
+
+/* double buffered samples, the ISR fills one buffer while the other
+ * holds the last completed scan */
+static uint16 Samples[2][ADC_MAX_SCAN_CHANNELS];
+static volatile uint8 WriteBuffer = 0;
+static volatile uint8 ReadBuffer = 1;
+
+/* simulated ADIE and ADATE bits, guarded by AdcLock as the ADC thread reads them */
+static pthread_mutex_t AdcLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t AdcStarted = PTHREAD_COND_INITIALIZER;
+static uint8 InterruptEnabled = 0;
+static uint8 AutoTrigger = 0;
+
+/**
+ * @brief read the stimulus file
+ *
+ */
+static void ADC_loadStimulus(void)
+{
+	const char * pPath = getenv("SFS_SIM_ADC");
+	ADC_Step_t step;
+	FILE * pFile;
+	char line[256];
+	char * pText;
+	char * pEnd;
+	unsigned long value;
+	uint8 i;
+
+	for(i = 0; i < ADC_SIM_CHANNELS; i++)
+	{
+		step.Values[i] = ADC_SIM_DEFAULT;
+	}
+
+	if(NULL == pPath)
+	{
+		return;
+	}
+
+	pFile = fopen(pPath, "r");
+	if(NULL == pFile)
+	{
+		perror(pPath);
+		return;
+	}
+
+	while(NULL != fgets(line, sizeof(line), pFile))
+	{
+		value = strtoul(line, &pEnd, 10);
+		if((pEnd == line) || ('#' == line[0]))
+		{
+			continue;
+		}
+		step.TimeUs = (uint64_t)value * 1000ULL;
+
+		pText = pEnd;
+		for(i = 0; i < ADC_SIM_CHANNELS; i++)
+		{
+			value = strtoul(pText, &pEnd, 10);
+			if(pEnd == pText)
+			{
+				break;
+			}
+			step.Values[i] = (uint16)(value & 0x3FF);
+			pText = pEnd;
+		}
+
+		Steps = realloc(Steps, (StepCount + 1) * sizeof(ADC_Step_t));
+		if(NULL == Steps)
+		{
+			abort();
+		}
+		Steps[StepCount] = step;
+		StepCount++;
+	}
+
+	fclose(pFile);
+}
+
+/**
+ * @brief value of a channel now, the steps are in time order
+ *
+ */
+static uint16 ADC_convert(uint8 channel_num)
+{
+	uint64_t now = ullPortSimTimeUs();
+
+	while(((StepIndex + 1) < StepCount) && (Steps[StepIndex + 1].TimeUs <= now))
+	{
+		StepIndex++;
+	}
+
+	if((0 == StepCount) || (Steps[StepIndex].TimeUs > now))
+	{
+		return ADC_SIM_DEFAULT;
+	}
+
+	return Steps[StepIndex].Values[channel_num];
+}
+
+/**
+ * @brief host thread of timer0 and the ADC, raises the ADC interrupt at the
+ * end of each conversion while the interrupt is enabled
+ *
+ */
+static void * ADC_thread(void * pvParam)
+{
+	uint8 autoTrigger;
+
+	(void)pvParam;
+
+	while(1)
+	{
+		pthread_mutex_lock(&AdcLock);
+		while(0 == InterruptEnabled)
+		{
+			pthread_cond_wait(&AdcStarted, &AdcLock);
+		}
+		autoTrigger = AutoTrigger;
+		pthread_mutex_unlock(&AdcLock);
+
+		vPortSimSleepUs(autoTrigger ? ADC_SIM_TRIGGER_US : ADC_SIM_CONVERSION_US);
+		vPortSimRaiseIsr(ADC_vect_num);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief set the simulated ADIE and ADATE bits
+ *
+ */
+static void ADC_setMode(uint8 interrupt, uint8 autoTrigger)
+{
+	pthread_mutex_lock(&AdcLock);
+	InterruptEnabled = interrupt;
+	AutoTrigger = autoTrigger;
+	pthread_cond_signal(&AdcStarted);
+	pthread_mutex_unlock(&AdcLock);
+}
+
+void ADC_init(void)
+{
+	static pthread_t thread;
+
+	ADC_loadStimulus();
+
+	vPortSimInstallIsr(ADC_vect_num, ADC_vect);
+	if(0 != pthread_create(&thread, NULL, ADC_thread, NULL))
+	{
+		abort();
+	}
+}
+
+uint16 ADC_readChannel(uint8 channel_num)
+{
+	/* channel number must be from (0 --> 7) */
+	channel_num &= 0x07;
+
+	/* the CPU busy waits the conversion */
+	vPortSimSleepUs(ADC_SIM_CONVERSION_US);
+
+	return ADC_convert(channel_num);
+}
+
+void ADC_setScan(const uint8 * pChannels, uint8 count, ADC_ScanCallback_t callback)
+{
+	uint8 i;
+
+	if(count > ADC_MAX_SCAN_CHANNELS)
+	{
+		count = ADC_MAX_SCAN_CHANNELS;
+	}
+	for(i = 0; i < count; i++)
+	{
+		/* channel number must be from (0 --> 7) */
+		ScanChannels[i] = pChannels[i] & 0x07;
+	}
+	ScanCount = count;
+	ScanCallback = callback;
+}
+
+/**
+ * @brief reset the scan state
+ *
+ * @return uint8 0 if a scan is already running or there is nothing to convert
+ */
+static uint8 ADC_prepareScan(void)
+{
+	uint8 i;
+
+	if(InterruptEnabled || (0 == ScanCount))
+	{
+		return 0;
+	}
+
+	ScanIndex = 0;
+	Passes = 0;
+	for(i = 0; i < ScanCount; i++)
+	{
+		Sums[i] = 0;
+	}
+
+	return 1;
+}
+
+void ADC_startScan(void)
+{
+	if(ADC_prepareScan())
+	{
+		ADC_setMode(1, 0);
+	}
+}
+
+void ADC_startContinuousScan(void)
+{
+	if(ADC_prepareScan())
+	{
+		ADC_setMode(1, 1);
+	}
+}
+
+void ADC_stopScan(void)
+{
+	ADC_setMode(0, 0);
+}
+
+uint16 ADC_getSample(uint8 index)
+{
+	uint16 sample;
+
+	/* the 16 bit read must not be split by the buffer swap in the ISR */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		sample = Samples[ReadBuffer][index];
+	}
+
+	return sample;
+}
+
+/**
+ * @brief conversion complete ISR, accumulate the sample and convert the next scan channel
+ *
+ */
+ISR(ADC_vect)
+{
+	uint8 i;
+
+	/* the scan was stopped after the conversion ended */
+	if(0 == InterruptEnabled)
+	{
+		return;
+	}
+
+	Sums[ScanIndex] += ADC_convert(ScanChannels[ScanIndex]);
+	ScanIndex++;
+
+	if(ScanIndex == ScanCount)
+	{
+		ScanIndex = 0;
+		Passes++;
+
+		if(ADC_OVERSAMPLE_COUNT == Passes)
+		{
+			/* decimate the oversampled sums and publish the filled buffer */
+			Passes = 0;
+			for(i = 0; i < ScanCount; i++)
+			{
+				Samples[WriteBuffer][i] = Sums[i] >> ADC_OVERSAMPLE_BITS;
+				Sums[i] = 0;
+			}
+			ReadBuffer = WriteBuffer;
+			WriteBuffer ^= 1;
+
+			/* single scan is done */
+			if(0 == AutoTrigger)
+			{
+				ADC_setMode(0, 0);
+			}
+
+			if(NULL_PTR != ScanCallback)
+			{
+				ScanCallback();
+			}
+		}
+	}
+}
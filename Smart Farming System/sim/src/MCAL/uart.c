@@ -0,0 +1,475 @@
+/**
+ * @file uart.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host simulation of the UART driver, the bytes are moved at the 9600
+ * baud of the target by two host threads in place of the USART
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * SFS_SIM_UART_RX  file read as the received bytes, "-" for stdin
+ * SFS_SIM_UART_TX  file written with the sent bytes, "-" for stdout
+ * a pseudo terminal is opened for the one not given and its name is printed
+ * on stderr, a terminal program or a script talks to the firmware through it
+ *
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <poll.h>
+#include <termios.h>
+#include <pthread.h>
+#include <avr/interrupt.h>
+#include "uart.h"
+#include "task.h"
+#include "semphr.h"
+
+#define UART_RX_MASK	(UART_RX_BUFFER_SIZE - 1)
+#define UART_TX_MASK	(UART_TX_BUFFER_SIZE - 1)
+
+#if (UART_RX_BUFFER_SIZE & UART_RX_MASK) || (UART_TX_BUFFER_SIZE & UART_TX_MASK)
+	#error UART buffer sizes must be a power of 2
+#endif
+
+/* time of one byte at 9600 baud, start bit, 8 data bits and stop bit */
+#define UART_SIM_BYTE_US	1042
+
+/* RX ring buffer, head is moved by the RX ISR and tail by the reader task */
+static uint8 RxBuffer[UART_RX_BUFFER_SIZE];
+static volatile uint8 RxHead = 0;
+static volatile uint8 RxTail = 0;
+
+/* TX ring buffer, head is moved by the writer tasks and tail by the UDRE ISR */
+static uint8 TxBuffer[UART_TX_BUFFER_SIZE];
+static volatile uint8 TxHead = 0;
+static volatile uint8 TxTail = 0;
+
+/* given by the RX ISR to wake up the task sleeping in UART_read() */
+static SemaphoreHandle_t bsRxReady = NULL;
+static StaticSemaphore_t RxReadyBuffer;
+
+/* given by the UDRE ISR to wake up the tasks sleeping in UART_sendByte() on a
+ * full TX buffer, only while TxWaiting counts such tasks */
+static SemaphoreHandle_t bsTxSpace = NULL;
+static StaticSemaphore_t TxSpaceBuffer;
+static volatile uint8 TxWaiting = 0;
+
+/* host files of the two directions */
+static int RxFile = -1;
+static int TxFile = -1;
+
+/* simulated UDR of the receiver and its RXC flag, the RX thread waits for the
+ * ISR to read the byte so no byte is overrun */
+static volatile uint8 RxData;
+static volatile uint8 RxComplete = 0;
+
+/* simulated UDRIE bit, guarded by TxLock as the TX thread waits on it */
+static pthread_mutex_t TxLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t TxEnabled = PTHREAD_COND_INITIALIZER;
+static uint8 TxInterruptEnabled = 0;
+
+/**
+ * @brief open a pseudo terminal in raw mode
+ *
+ * @return int file of the master side
+ */
+static int UART_openPty(void)
+{
+	static int master = -1;
+	struct termios tio;
+	int slave;
+
+	if(master >= 0)
+	{
+		return master;
+	}
+
+	master = posix_openpt(O_RDWR | O_NOCTTY);
+	if((master < 0) || (0 != grantpt(master)) || (0 != unlockpt(master)))
+	{
+		perror("pty");
+		exit(EXIT_FAILURE);
+	}
+
+	/* the slave stays open so the master never reads the end of file, raw
+	 * mode so the binary frames are not changed or echoed */
+	slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+	if(slave >= 0)
+	{
+		tcgetattr(slave, &tio);
+		cfmakeraw(&tio);
+		tcsetattr(slave, TCSANOW, &tio);
+	}
+
+	/* bytes are dropped while no program reads the pty, as on a serial line */
+	fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+	fprintf(stderr, "uart: %s\n", ptsname(master));
+
+	return master;
+}
+
+/**
+ * @brief open the file of one direction
+ *
+ */
+static int UART_openFile(const char * pVariable, int stdFile, int flags)
+{
+	const char * pPath = getenv(pVariable);
+	int file;
+
+	if(NULL == pPath)
+	{
+		return UART_openPty();
+	}
+	if(('-' == pPath[0]) && ('\0' == pPath[1]))
+	{
+		return stdFile;
+	}
+
+	file = open(pPath, flags, 0644);
+	if(file < 0)
+	{
+		perror(pPath);
+		exit(EXIT_FAILURE);
+	}
+
+	return file;
+}
+
+/**
+ * @brief host thread of the receiver, one byte every byte time
+ *
+ */
+static void * UART_rxThread(void * pvParam)
+{
+	struct pollfd input = {RxFile, POLLIN, 0};
+	uint8 data;
+	ssize_t count;
+
+	(void)pvParam;
+
+	while(1)
+	{
+		/* the pty is non blocking for the TX side, wait for the bytes here */
+		(void)poll(&input, 1, -1);
+		count = read(RxFile, &data, 1);
+		if(0 == count)
+		{
+			/* end of the file, nothing more is received */
+			return NULL;
+		}
+		if(count < 0)
+		{
+			continue;
+		}
+
+		vPortSimSleepUs(UART_SIM_BYTE_US);
+		while(__atomic_load_n(&RxComplete, __ATOMIC_ACQUIRE))
+		{
+			vPortSimSleepUs(UART_SIM_BYTE_US);
+		}
+		RxData = data;
+		__atomic_store_n(&RxComplete, 1, __ATOMIC_RELEASE);
+		vPortSimRaiseIsr(USART_RXC_vect_num);
+	}
+}
+
+/**
+ * @brief host thread of the transmitter, the data register is empty again
+ * one byte time after the ISR wrote it
+ *
+ */
+static void * UART_txThread(void * pvParam)
+{
+	(void)pvParam;
+
+	while(1)
+	{
+		pthread_mutex_lock(&TxLock);
+		while(0 == TxInterruptEnabled)
+		{
+			pthread_cond_wait(&TxEnabled, &TxLock);
+		}
+		pthread_mutex_unlock(&TxLock);
+
+		vPortSimRaiseIsr(USART_UDRE_vect_num);
+		vPortSimSleepUs(UART_SIM_BYTE_US);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief set the simulated UDRIE bit
+ *
+ */
+static void UART_setTxInterrupt(uint8 enable)
+{
+	pthread_mutex_lock(&TxLock);
+	TxInterruptEnabled = enable;
+	pthread_cond_signal(&TxEnabled);
+	pthread_mutex_unlock(&TxLock);
+}
+
+/**
+ * @brief send a byte to the host file
+ *
+ */
+static void UART_transmit(uint8 data)
+{
+	/* a full pty drops the byte */
+	(void)write(TxFile, &data, 1);
+}
+
+void UART_init(void)
+{
+	pthread_t thread;
+
+	RxFile = UART_openFile("SFS_SIM_UART_RX", STDIN_FILENO, O_RDONLY);
+	TxFile = UART_openFile("SFS_SIM_UART_TX", STDOUT_FILENO, O_WRONLY | O_CREAT | O_TRUNC);
+
+	bsRxReady = xSemaphoreCreateBinaryStatic(&RxReadyBuffer);
+	bsTxSpace = xSemaphoreCreateBinaryStatic(&TxSpaceBuffer);
+
+	vPortSimInstallIsr(USART_RXC_vect_num, USART_RXC_vect);
+	vPortSimInstallIsr(USART_UDRE_vect_num, USART_UDRE_vect);
+
+	if((0 != pthread_create(&thread, NULL, UART_rxThread, NULL)) ||
+	   (0 != pthread_create(&thread, NULL, UART_txThread, NULL)))
+	{
+		abort();
+	}
+}
+
+uint8 UART_write(const uint8 * pBuf, uint8 len)
+{
+	uint8 count = 0;
+	uint8 next;
+
+	taskENTER_CRITICAL();
+	while(count < len)
+	{
+		next = (TxHead + 1) & UART_TX_MASK;
+		/* TX buffer is full */
+		if(next == TxTail)
+		{
+			break;
+		}
+		TxBuffer[TxHead] = pBuf[count];
+		TxHead = next;
+		count++;
+	}
+	/* the UDRE ISR disables itself when the TX buffer becomes empty */
+	if(count > 0)
+	{
+		UART_setTxInterrupt(1);
+	}
+	taskEXIT_CRITICAL();
+
+	return count;
+}
+
+ERROR_t UART_writeFrame(const uint8 * pBuf, uint8 len)
+{
+	ERROR_t result = E_NOK;
+
+	taskENTER_CRITICAL();
+	/* one entry is always free to tell a full buffer from an empty one */
+	if(((UART_TX_BUFFER_SIZE - 1) - ((TxHead - TxTail) & UART_TX_MASK)) >= len)
+	{
+		(void)UART_write(pBuf, len);
+		result = E_OK;
+	}
+	taskEXIT_CRITICAL();
+
+	return result;
+}
+
+uint8 UART_read(uint8 * pBuf, uint8 len, TickType_t xTimeout)
+{
+	uint8 count = 0;
+
+	while(count < len)
+	{
+		if(E_OK == UART_receiveByte_NonBlocking(&pBuf[count]))
+		{
+			count++;
+		}
+		/* buffer is empty so sleep until the RX ISR receives a new byte */
+		else if(pdFALSE == xSemaphoreTake(bsRxReady, xTimeout))
+		{
+			break;
+		}
+	}
+
+	return count;
+}
+
+void UART_sendByte(const uint8 data)
+{
+	uint8 full;
+
+	/* wait only if the TX buffer is full */
+	while(0 == UART_write(&data, 1))
+	{
+		/* interrupts are disabled (e.g. before the scheduler starts) so the UDRE
+		 * ISR can not drain the buffer, send the oldest byte by polling */
+		if(BIT_IS_CLEAR(SREG,SREG_I))
+		{
+			vPortSimSleepUs(UART_SIM_BYTE_US);
+			UART_transmit(TxBuffer[TxTail]);
+			TxTail = (TxTail + 1) & UART_TX_MASK;
+		}
+		else
+		{
+			/* sleep until the UDRE ISR sends a byte, the buffer is checked again
+			 * with the interrupts disabled so that byte can not be missed */
+			taskENTER_CRITICAL();
+			full = (((TxHead + 1) & UART_TX_MASK) == TxTail);
+			if(full)
+			{
+				TxWaiting++;
+			}
+			taskEXIT_CRITICAL();
+
+			if(full)
+			{
+				(void)xSemaphoreTake(bsTxSpace, portMAX_DELAY);
+				taskENTER_CRITICAL();
+				TxWaiting--;
+				taskEXIT_CRITICAL();
+			}
+		}
+	}
+}
+
+void UART_flushPolled(void)
+{
+	/* with the interrupts enabled the UDRE ISR owns the tail */
+	if(BIT_IS_SET(SREG,SREG_I))
+	{
+		return;
+	}
+
+	while(TxHead != TxTail)
+	{
+		vPortSimSleepUs(UART_SIM_BYTE_US);
+		UART_transmit(TxBuffer[TxTail]);
+		TxTail = (TxTail + 1) & UART_TX_MASK;
+	}
+	UART_setTxInterrupt(0);
+}
+
+uint8 UART_receiveByte(void)
+{
+	uint8 data;
+
+	/* sleep until a byte is received */
+	while(0 == UART_read(&data, 1, portMAX_DELAY)){}
+
+	return data;
+}
+
+ERROR_t UART_receiveByte_NonBlocking(uint8 * pData)
+{
+	/* check if there is data in the RX buffer */
+	if(RxHead != RxTail)
+	{
+		*pData = RxBuffer[RxTail];
+		RxTail = (RxTail + 1) & UART_RX_MASK;
+		return E_OK;
+	}
+	else
+	{
+		return PENDING;
+	}
+}
+
+void UART_sendString(const char *Str)
+{
+	uint8 i = 0;
+	while(Str[i] != '\0')
+	{
+		UART_sendByte(Str[i]);
+		i++;
+	}
+}
+
+void UART_receiveString(char *Str)
+{
+	uint8 i = 0;
+	Str[i] = UART_receiveByte();
+
+	/* receive till # end of string */
+	while(Str[i] != '#')
+	{
+		i++;
+		Str[i] = UART_receiveByte();
+	}
+	/* add null at the end of string */
+	Str[i] = '\0';
+}
+
+/**
+ * @brief RX complete ISR, store the received byte and wake up the reader task
+ *
+ */
+ISR(USART_RXC_vect)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	/* read UDR in all cases to clear the RXC flag */
+	uint8 data = RxData;
+	uint8 next = (RxHead + 1) & UART_RX_MASK;
+
+	__atomic_store_n(&RxComplete, 0, __ATOMIC_RELEASE);
+
+	/* drop the byte if the RX buffer is full */
+	if(next != RxTail)
+	{
+		RxBuffer[RxHead] = data;
+		RxHead = next;
+	}
+
+	xSemaphoreGiveFromISR(bsRxReady, &xHigherPriorityTaskWoken);
+	if(pdFALSE != xHigherPriorityTaskWoken)
+	{
+		taskYIELD();
+	}
+}
+
+/**
+ * @brief data register empty ISR, send the next byte from the TX buffer and
+ * wake up a task waiting for room
+ *
+ */
+ISR(USART_UDRE_vect)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	if(TxHead != TxTail)
+	{
+		UART_transmit(TxBuffer[TxTail]);
+		TxTail = (TxTail + 1) & UART_TX_MASK;
+
+		/* an entry is free, wake up a task waiting for one */
+		if(TxWaiting)
+		{
+			xSemaphoreGiveFromISR(bsTxSpace, &xHigherPriorityTaskWoken);
+		}
+	}
+	else
+	{
+		/* nothing to send, disable the interrupt until new data is queued */
+		UART_setTxInterrupt(0);
+	}
+
+	if(pdFALSE != xHigherPriorityTaskWoken)
+	{
+		taskYIELD();
+	}
+}
@@ -0,0 +1,123 @@
+/**
+ * @file eeprom.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host simulation of the EEPROM, the image of the EEMEM variables is
+ * read from the SFS_SIM_EEPROM file on the first access and written back after
+ * each update, without the file the EEPROM starts erased and is not kept
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <avr/eeprom.h>
+
+/* bounds of the EEMEM variables, given by the linker */
+extern uint8_t __start_sim_eeprom[] __attribute__((weak));
+extern uint8_t __stop_sim_eeprom[] __attribute__((weak));
+
+static uint8_t Eeprom_Loaded = 0;
+
+/**
+ * @brief size of the EEPROM image in bytes
+ *
+ */
+static size_t Eeprom_size(void)
+{
+	return (size_t)(__stop_sim_eeprom - __start_sim_eeprom);
+}
+
+/**
+ * @brief fill the image from the file or erase it, once
+ *
+ */
+static void Eeprom_load(void)
+{
+	const char * pPath = getenv("SFS_SIM_EEPROM");
+	FILE * pFile;
+	size_t count = 0;
+
+	if(Eeprom_Loaded)
+	{
+		return;
+	}
+	Eeprom_Loaded = 1;
+
+	if(NULL != pPath)
+	{
+		pFile = fopen(pPath, "rb");
+		if(NULL != pFile)
+		{
+			count = fread(__start_sim_eeprom, 1, Eeprom_size(), pFile);
+			fclose(pFile);
+		}
+	}
+
+	/* the bytes not in the file read as erased */
+	memset(__start_sim_eeprom + count, 0xFF, Eeprom_size() - count);
+}
+
+/**
+ * @brief write the image to the file
+ *
+ */
+static void Eeprom_save(void)
+{
+	const char * pPath = getenv("SFS_SIM_EEPROM");
+	FILE * pFile;
+
+	if(NULL == pPath)
+	{
+		return;
+	}
+
+	pFile = fopen(pPath, "wb");
+	if(NULL != pFile)
+	{
+		fwrite(__start_sim_eeprom, 1, Eeprom_size(), pFile);
+		fclose(pFile);
+	}
+}
+
+void eeprom_read_block(void * __dst, const void * __src, size_t __n)
+{
+	Eeprom_load();
+	memcpy(__dst, __src, __n);
+}
+
+uint8_t eeprom_read_byte(const uint8_t * __p)
+{
+	Eeprom_load();
+	return *__p;
+}
+
+void eeprom_update_block(const void * __src, void * __dst, size_t __n)
+{
+	Eeprom_load();
+	if(0 != memcmp(__dst, __src, __n))
+	{
+		memcpy(__dst, __src, __n);
+		Eeprom_save();
+	}
+}
+
+void eeprom_update_byte(uint8_t * __p, uint8_t __value)
+{
+	Eeprom_load();
+	if(*__p != __value)
+	{
+		*__p = __value;
+		Eeprom_save();
+	}
+}
+
+void eeprom_write_byte(uint8_t * __p, uint8_t __value)
+{
+	Eeprom_load();
+	*__p = __value;
+	Eeprom_save();
+}
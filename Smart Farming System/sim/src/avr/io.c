@@ -0,0 +1,20 @@
+/**
+ * @file io.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host simulation of the ATmega32 i/o ports and the USART registers,
+ * the other registers of the simulated drivers are not needed
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <avr/io.h>
+
+volatile uint8_t PORTA, DDRA, PINA;
+volatile uint8_t PORTB, DDRB, PINB;
+volatile uint8_t PORTC, DDRC, PINC;
+volatile uint8_t PORTD, DDRD, PIND;
+
+volatile uint8_t UDR, UCSRA, UCSRB, UCSRC, UBRRH, UBRRL;
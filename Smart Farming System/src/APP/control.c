@@ -0,0 +1,300 @@
+/**
+ * @file control.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief actuators control engine (on/off with hysteresis or PID)
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include "control.h"
+#include "task.h"
+
+/* the integral term at its limit is a whole window, the sum of the error is
+ * kept under this divided by Ki */
+#define CONTROL_INTEGRAL_RANGE	((sint32)CONTROL_WINDOW_SLOTS << CONTROL_GAIN_BITS)
+
+/**
+ * @brief on/off mode settings
+ *
+ */
+typedef struct
+{
+	sint16 Band;
+	TickType_t MinOn;
+	TickType_t MinOff;
+} Control_Config_t;
+
+/**
+ * @brief actuator state
+ *
+ */
+typedef struct
+{
+	uint8 On;
+	uint8 Switched;			/* changed at least once, the first change is not held back */
+	TickType_t LastChange;	/* tick of the last change */
+	uint8 Locked;			/* kept off by an interlock */
+	uint8 HoldOff;			/* PID mode after an interlock, off for the min off time */
+
+	/* PID mode */
+	uint8 Slot;				/* current slot in the window */
+	uint8 Duty;				/* on slots in the current window */
+	TickType_t SlotStart;	/* tick of the current slot start */
+	sint16 Integral;		/* sum of the error, once per window */
+	sint16 LastError;
+} Control_Actuator_t;
+
+static const Control_Config_t Control_Config[CONTROL_ACTUATORS] =
+{
+	{ CONTROL_COOLER_BAND, CONTROL_COOLER_MIN_ON, CONTROL_COOLER_MIN_OFF },
+	{ CONTROL_HEATER_BAND, CONTROL_HEATER_MIN_ON, CONTROL_HEATER_MIN_OFF },
+	{ CONTROL_PUMP_BAND,   CONTROL_PUMP_MIN_ON,   CONTROL_PUMP_MIN_OFF   }
+};
+
+static Control_Tuning_t Control_Tunings[CONTROL_ACTUATORS];
+
+static Control_Actuator_t Control_Actuators[CONTROL_ACTUATORS];
+
+/**
+ * @brief clear the PID state so the next update starts a new window
+ *
+ * @param pAct actuator
+ * @param now current tick count
+ */
+static void Control_restart(Control_Actuator_t * pAct, TickType_t now)
+{
+	pAct->Slot = CONTROL_WINDOW_SLOTS - 1;
+	pAct->Duty = 0;
+	pAct->SlotStart = (TickType_t)(now - CONTROL_SLOT_TICKS);
+	pAct->Integral = 0;
+	pAct->LastError = 0;
+}
+
+/**
+ * @brief change the actuator state
+ *
+ * @param pAct actuator
+ * @param on new state
+ * @param now current tick count
+ */
+static void Control_switch(Control_Actuator_t * pAct, uint8 on, TickType_t now)
+{
+	if(on != pAct->On)
+	{
+		pAct->On = on;
+		pAct->Switched = 1;
+		pAct->LastChange = now;
+	}
+}
+
+/**
+ * @brief on/off with hysteresis band and min dwell time
+ *
+ */
+static void Control_onOff(uint8 actuator, sint16 error, TickType_t now, TickType_t * pWait)
+{
+	const Control_Config_t * pCfg = &Control_Config[actuator];
+	Control_Actuator_t * pAct = &Control_Actuators[actuator];
+	TickType_t dwell;
+	TickType_t elapsed;
+	uint8 want = pAct->On;
+
+	/* inside the band keep the current state */
+	if(error > pCfg->Band)
+	{
+		want = 1;
+	}
+	else if(error <= 0)
+	{
+		want = 0;
+	}
+
+	if(want != pAct->On)
+	{
+		dwell = pAct->On ? pCfg->MinOn : pCfg->MinOff;
+		/* unsigned difference is right across the tick counter overflow */
+		elapsed = (TickType_t)(now - pAct->LastChange);
+
+		if(pAct->Switched && (elapsed < dwell))
+		{
+			if((TickType_t)(dwell - elapsed) < *pWait)
+			{
+				*pWait = dwell - elapsed;
+			}
+		}
+		else
+		{
+			Control_switch(pAct, want, now);
+		}
+	}
+}
+
+/**
+ * @brief PID step, once per window, sets the on slots of the next window
+ *
+ */
+static void Control_pidStep(uint8 actuator, sint16 error)
+{
+	const Control_Tuning_t * pTun = &Control_Tunings[actuator];
+	Control_Actuator_t * pAct = &Control_Actuators[actuator];
+	sint32 out;
+	sint16 integral = pAct->Integral + error;
+	/* once per window, the division is cheap next to the window time */
+	sint16 integralMax = pTun->Ki ? (sint16)(CONTROL_INTEGRAL_RANGE / pTun->Ki) : 0;
+
+	if(integral > integralMax)
+	{
+		integral = integralMax;
+	}
+	else if(integral < -integralMax)
+	{
+		integral = -integralMax;
+	}
+
+	out = ( ((sint32)pTun->Kp * error)
+		  + ((sint32)pTun->Ki * integral)
+		  + ((sint32)pTun->Kd * (error - pAct->LastError)) ) >> CONTROL_GAIN_BITS;
+
+	/* anti windup: the integral only moves while the output is not saturated
+	 * in the same direction */
+	if( ((out < CONTROL_WINDOW_SLOTS) || (error < 0)) && ((out > 0) || (error > 0)) )
+	{
+		pAct->Integral = integral;
+	}
+	pAct->LastError = error;
+
+	if(out < CONTROL_MIN_SLOTS)
+	{
+		pAct->Duty = 0;
+	}
+	else if(out > (CONTROL_WINDOW_SLOTS - CONTROL_MIN_SLOTS))
+	{
+		pAct->Duty = CONTROL_WINDOW_SLOTS;
+	}
+	else
+	{
+		pAct->Duty = (uint8)out;
+	}
+}
+
+/**
+ * @brief time proportioned relay, moves the slot clock and runs the PID at the
+ * start of each window
+ *
+ */
+static void Control_pid(uint8 actuator, sint16 error, TickType_t now, TickType_t * pWait)
+{
+	const Control_Config_t * pCfg = &Control_Config[actuator];
+	Control_Actuator_t * pAct = &Control_Actuators[actuator];
+	TickType_t elapsed = (TickType_t)(now - pAct->SlotStart);
+	TickType_t off;
+	uint8 newWindow = 0;
+	uint8 on;
+
+	/* slots move by a fixed number of ticks, a late call does not shift the rate */
+	while(elapsed >= CONTROL_SLOT_TICKS)
+	{
+		elapsed -= CONTROL_SLOT_TICKS;
+		pAct->SlotStart += CONTROL_SLOT_TICKS;
+
+		if(++pAct->Slot >= CONTROL_WINDOW_SLOTS)
+		{
+			pAct->Slot = 0;
+			newWindow = 1;
+		}
+	}
+
+	if(newWindow)
+	{
+		Control_pidStep(actuator, error);
+	}
+
+	on = (pAct->Slot < pAct->Duty);
+
+	/* the windows do not keep the min off time, after an interlock the relay
+	 * waits for it before the first on slot */
+	if(on && pAct->HoldOff)
+	{
+		off = (TickType_t)(now - pAct->LastChange);
+		if(pAct->Switched && (off < pCfg->MinOff))
+		{
+			on = 0;
+		}
+		else
+		{
+			pAct->HoldOff = 0;
+		}
+	}
+
+	Control_switch(pAct, on, now);
+
+	if((TickType_t)(CONTROL_SLOT_TICKS - elapsed) < *pWait)
+	{
+		*pWait = CONTROL_SLOT_TICKS - elapsed;
+	}
+}
+
+void Control_init(void)
+{
+	uint8 k;
+
+	for(k = 0; k < CONTROL_ACTUATORS; k++)
+	{
+		Control_Tunings[k].Mode = CONTROL_DEFAULT_MODE;
+		Control_Tunings[k].Kp = (k == CONTROL_PUMP) ? CONTROL_HUMI_KP : CONTROL_TEMP_KP;
+		Control_Tunings[k].Ki = (k == CONTROL_PUMP) ? CONTROL_HUMI_KI : CONTROL_TEMP_KI;
+		Control_Tunings[k].Kd = (k == CONTROL_PUMP) ? CONTROL_HUMI_KD : CONTROL_TEMP_KD;
+		Control_restart(&Control_Actuators[k], 0);
+	}
+}
+
+uint8 Control_update(uint8 actuator, sint16 error, TickType_t now, TickType_t * pWait)
+{
+	Control_Actuator_t * pAct = &Control_Actuators[actuator];
+
+	if(pAct->Locked)
+	{
+		/* off at once, without the min on time, the min off time starts here */
+		Control_switch(pAct, 0, now);
+		if(CONTROL_MODE_PID == Control_Tunings[actuator].Mode)
+		{
+			/* a new window when released, the error meanwhile is not summed */
+			Control_restart(pAct, now);
+			pAct->HoldOff = 1;
+		}
+	}
+	else if(CONTROL_MODE_PID == Control_Tunings[actuator].Mode)
+	{
+		Control_pid(actuator, error, now, pWait);
+	}
+	else
+	{
+		Control_onOff(actuator, error, now, pWait);
+	}
+
+	return Control_Actuators[actuator].On;
+}
+
+void Control_interlock(uint8 actuator, uint8 locked)
+{
+	Control_Actuators[actuator].Locked = locked;
+}
+
+ERROR_t Control_setTuning(uint8 actuator, const Control_Tuning_t * pTuning)
+{
+	if((actuator >= CONTROL_ACTUATORS) || (pTuning->Mode > CONTROL_MODE_PID))
+	{
+		return E_NOK;
+	}
+
+	/* the control task has a higher priority and may be in the middle of an update */
+	taskENTER_CRITICAL();
+	Control_Tunings[actuator] = *pTuning;
+	Control_restart(&Control_Actuators[actuator], xTaskGetTickCount());
+	taskEXIT_CRITICAL();
+
+	return E_OK;
+}
@@ -0,0 +1,163 @@
+/**
+ * @file datamodel.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief system data shared by the tasks
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include "datamodel.h"
+#include "snapshot.h"
+
+/**
+ * @brief subscriber of the data model
+ *
+ */
+typedef struct
+{
+	DataModel_Fields_t Fields;
+	DataModel_Callback_t Callback;
+} DataModel_Subscriber_t;
+
+static DataModel_Subscriber_t DataModel_Subscribers[DATAMODEL_MAX_SUBSCRIBERS];
+static uint8 DataModel_SubscriberCount = 0;
+
+/* data groups and their sequences */
+static SensorData_t DataModel_SensorData = {DATAMODEL_DEFAULT_TEMP, DATAMODEL_DEFAULT_HUMI};
+static Snapshot_t DataModel_SensorDataSnapshot;
+
+static SensorThreshold_t DataModel_Threshold = {DATAMODEL_DEFAULT_TEMP_T, DATAMODEL_DEFAULT_HUMI_T};
+static Snapshot_t DataModel_ThresholdSnapshot;
+
+static Motors_t DataModel_Motors = {OFF, OFF, OFF};
+static Snapshot_t DataModel_MotorsSnapshot;
+
+static volatile SystemState_t DataModel_State = MainState;
+
+/**
+ * @brief call the subscribers of the changed fields
+ *
+ */
+static void DataModel_notify(DataModel_Fields_t changed)
+{
+	uint8 k;
+
+	for(k = 0; k < DataModel_SubscriberCount; k++)
+	{
+		if(DataModel_Subscribers[k].Fields & changed)
+		{
+			DataModel_Subscribers[k].Callback(DataModel_Subscribers[k].Fields & changed);
+		}
+	}
+}
+
+ERROR_t DataModel_subscribe(DataModel_Fields_t fields, DataModel_Callback_t callback)
+{
+	if((NULL_PTR == callback) || (DataModel_SubscriberCount >= DATAMODEL_MAX_SUBSCRIBERS))
+	{
+		return E_NOK;
+	}
+
+	DataModel_Subscribers[DataModel_SubscriberCount].Fields = fields;
+	DataModel_Subscribers[DataModel_SubscriberCount].Callback = callback;
+	DataModel_SubscriberCount++;
+
+	return E_OK;
+}
+
+void DataModel_getSensorData(SensorData_t * pData)
+{
+	SNAPSHOT_READ(DataModel_SensorDataSnapshot, DataModel_SensorData, *pData);
+}
+
+void DataModel_setSensorData(const SensorData_t * pData)
+{
+	DataModel_Fields_t changed = 0;
+
+	/* only the writer calls the set, it reads its own data directly */
+	if(pData->TempData != DataModel_SensorData.TempData)
+	{
+		changed |= DM_TEMP;
+	}
+	if(pData->HumiData != DataModel_SensorData.HumiData)
+	{
+		changed |= DM_HUMI;
+	}
+
+	if(changed)
+	{
+		SNAPSHOT_WRITE(DataModel_SensorDataSnapshot, DataModel_SensorData, *pData);
+		DataModel_notify(changed);
+	}
+}
+
+void DataModel_getThreshold(SensorThreshold_t * pThreshold)
+{
+	SNAPSHOT_READ(DataModel_ThresholdSnapshot, DataModel_Threshold, *pThreshold);
+}
+
+void DataModel_setThreshold(const SensorThreshold_t * pThreshold)
+{
+	DataModel_Fields_t changed = 0;
+
+	if(pThreshold->TempT != DataModel_Threshold.TempT)
+	{
+		changed |= DM_TEMP_T;
+	}
+	if(pThreshold->HumiT != DataModel_Threshold.HumiT)
+	{
+		changed |= DM_HUMI_T;
+	}
+
+	if(changed)
+	{
+		SNAPSHOT_WRITE(DataModel_ThresholdSnapshot, DataModel_Threshold, *pThreshold);
+		DataModel_notify(changed);
+	}
+}
+
+void DataModel_getMotors(Motors_t * pMotors)
+{
+	SNAPSHOT_READ(DataModel_MotorsSnapshot, DataModel_Motors, *pMotors);
+}
+
+void DataModel_setMotors(const Motors_t * pMotors)
+{
+	DataModel_Fields_t changed = 0;
+
+	if(pMotors->Water_Pump != DataModel_Motors.Water_Pump)
+	{
+		changed |= DM_PUMP;
+	}
+	if(pMotors->Heater != DataModel_Motors.Heater)
+	{
+		changed |= DM_HEATER;
+	}
+	if(pMotors->Cooler != DataModel_Motors.Cooler)
+	{
+		changed |= DM_COOLER;
+	}
+
+	if(changed)
+	{
+		SNAPSHOT_WRITE(DataModel_MotorsSnapshot, DataModel_Motors, *pMotors);
+		DataModel_notify(changed);
+	}
+}
+
+SystemState_t DataModel_getState(void)
+{
+	return DataModel_State;
+}
+
+void DataModel_setState(SystemState_t state)
+{
+	if(state != DataModel_State)
+	{
+		DataModel_State = state;
+		DataModel_notify(DM_STATE);
+	}
+}
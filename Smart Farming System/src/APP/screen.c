@@ -0,0 +1,198 @@
+/**
+ * @file screen.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief screen layouts and renderer of the display task
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include "string.h"
+#include "screen.h"
+#include "format.h"
+
+/**
+ * @brief write a number right aligned in the 3 cells of its field
+ *
+ */
+static uint8 Screen_number(uint8 value, char * pText)
+{
+	return Format_u8(value, pText, FORMAT_U8_DIGITS);
+}
+
+/**
+ * @brief write the state of a motor
+ *
+ */
+static uint8 Screen_motor(Motor state, char * pText)
+{
+	if(ON == state)
+	{
+		pText[0] = 'O';
+		pText[1] = 'N';
+		return 2;
+	}
+
+	pText[0] = 'O';
+	pText[1] = 'F';
+	pText[2] = 'F';
+	return 3;
+}
+
+static uint8 Screen_temp(const Screen_Data_t * pData, char * pText)
+{
+	return Screen_number(pData->Sensors.TempData, pText);
+}
+
+static uint8 Screen_humi(const Screen_Data_t * pData, char * pText)
+{
+	return Screen_number(pData->Sensors.HumiData, pText);
+}
+
+static uint8 Screen_tempT(const Screen_Data_t * pData, char * pText)
+{
+	return Screen_number(pData->Threshold.TempT, pText);
+}
+
+static uint8 Screen_humiT(const Screen_Data_t * pData, char * pText)
+{
+	return Screen_number(pData->Threshold.HumiT, pText);
+}
+
+static uint8 Screen_pump(const Screen_Data_t * pData, char * pText)
+{
+	return Screen_motor(pData->Motors.Water_Pump, pText);
+}
+
+static uint8 Screen_heater(const Screen_Data_t * pData, char * pText)
+{
+	return Screen_motor(pData->Motors.Heater, pText);
+}
+
+static uint8 Screen_cooler(const Screen_Data_t * pData, char * pText)
+{
+	return Screen_motor(pData->Motors.Cooler, pText);
+}
+
+/******************************* main screen ********************************/
+static const Screen_Field_t Screen_MainFields[] =
+{
+	/* field		row	col	width	formatter */
+	{DM_TEMP,		0,	4,	3,		Screen_temp},
+	{DM_HUMI,		0,	16,	3,		Screen_humi},
+	{DM_TEMP_T,		1,	4,	3,		Screen_tempT},
+	{DM_HUMI_T,		1,	16,	3,		Screen_humiT},
+	{DM_HEATER,		2,	2,	3,		Screen_heater},
+	{DM_COOLER,		2,	10,	3,		Screen_cooler},
+	{DM_PUMP,		2,	17,	3,		Screen_pump},
+};
+
+const Screen_t Screen_Main =
+{
+	{
+		"T =    C    H =    %",
+		"TT=    C    TH=    %",
+		"H:      C:     P:   ",
+		/* the trends of the readings, LCD_GLYPH(0) to LCD_GLYPH(7) */
+		"T\010\011\012\013 H\014\015\016\017 Config:C",
+	},
+	Screen_MainFields,
+	sizeof(Screen_MainFields) / sizeof(Screen_MainFields[0])
+};
+
+/****************************** config screen *******************************/
+static const Screen_Field_t Screen_ConfigFields[] =
+{
+	/* field		row						col					width	formatter */
+	{DM_TEMP_T,		SCREEN_CONFIG_TEMP_ROW,	SCREEN_CONFIG_COL,	3,		Screen_tempT},
+	{DM_HUMI_T,		SCREEN_CONFIG_HUMI_ROW,	SCREEN_CONFIG_COL,	3,		Screen_humiT},
+};
+
+const Screen_t Screen_Config =
+{
+	{
+		"TempThreshold:     C",
+		NULL,
+		"HumiThreshold:     %",
+		"OK:O Next:N Cancel:C",
+	},
+	Screen_ConfigFields,
+	sizeof(Screen_ConfigFields) / sizeof(Screen_ConfigFields[0])
+};
+
+/**
+ * @brief write the text of a field in its cells, the cells after the text are
+ * cleared
+ *
+ */
+static void Screen_format(const Screen_Field_t * pField, const Screen_Data_t * pData, char * pCells)
+{
+	char text[SCREEN_MAX_WIDTH];
+	uint8 length;
+	uint8 i;
+
+	length = pField->Format(pData, text);
+	/* the width of a field is at most SCREEN_MAX_WIDTH */
+	for(i = 0; (i < pField->Width) && (i < SCREEN_MAX_WIDTH); i++)
+	{
+		pCells[i] = (i < length) ? text[i] : ' ';
+	}
+}
+
+void Screen_draw(const Screen_t * pScreen, const Screen_Data_t * pData)
+{
+	char cells[LCD_COLS];
+	uint8 row;
+	uint8 k;
+
+	/* each row is built with its fields first, the frame buffer then sees a
+	 * field cell change once, not to a space and back */
+	for(row = 0; row < LCD_ROWS; row++)
+	{
+		if(NULL_PTR == pScreen->Lines[row])
+		{
+			memset(cells, ' ', LCD_COLS);
+		}
+		else
+		{
+			memcpy(cells, pScreen->Lines[row], LCD_COLS);
+		}
+
+		for(k = 0; k < pScreen->FieldCount; k++)
+		{
+			if(pScreen->Fields[k].Row == row)
+			{
+				Screen_format(&pScreen->Fields[k], pData, &cells[pScreen->Fields[k].Col]);
+			}
+		}
+
+		LCD_goToRowColumn(row, 0);
+		for(k = 0; k < LCD_COLS; k++)
+		{
+			LCD_displayCharacter(cells[k]);
+		}
+	}
+}
+
+void Screen_update(const Screen_t * pScreen, const Screen_Data_t * pData, DataModel_Fields_t changed)
+{
+	char cells[SCREEN_MAX_WIDTH];
+	uint8 k;
+	uint8 i;
+
+	for(k = 0; k < pScreen->FieldCount; k++)
+	{
+		if(pScreen->Fields[k].Field & changed)
+		{
+			Screen_format(&pScreen->Fields[k], pData, cells);
+
+			LCD_goToRowColumn(pScreen->Fields[k].Row, pScreen->Fields[k].Col);
+			for(i = 0; (i < pScreen->Fields[k].Width) && (i < SCREEN_MAX_WIDTH); i++)
+			{
+				LCD_displayCharacter(cells[i]);
+			}
+		}
+	}
+}
@@ -0,0 +1,58 @@
+/**
+ * @file snapshot.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief versioned snapshots of the data shared by the tasks
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include "snapshot.h"
+#include "task.h"
+
+/* the data groups are not volatile, keeps the compiler from moving their
+ * accesses across the sequence accesses or out of the critical section */
+#define SNAPSHOT_BARRIER()	__asm__ __volatile__ ("" ::: "memory")
+
+void Snapshot_write(Snapshot_t * pSnap, void * pData, const void * pValue, uint8 size)
+{
+	uint8 * pDst = (uint8 *)pData;
+	const uint8 * pSrc = (const uint8 *)pValue;
+
+	taskENTER_CRITICAL();
+	SNAPSHOT_BARRIER();
+	while(size--)
+	{
+		*pDst++ = *pSrc++;
+	}
+	pSnap->Sequence++;
+	SNAPSHOT_BARRIER();
+	taskEXIT_CRITICAL();
+}
+
+void Snapshot_read(const Snapshot_t * pSnap, const void * pData, void * pCopy, uint8 size)
+{
+	const uint8 * pSrc;
+	uint8 * pDst;
+	uint8 count;
+	uint8 sequence;
+
+	/* a write preempting the copy bumps the sequence, the 8 bit sequence would
+	 * only miss it after 256 writes during one copy */
+	do
+	{
+		sequence = pSnap->Sequence;
+		SNAPSHOT_BARRIER();
+
+		pSrc = (const uint8 *)pData;
+		pDst = (uint8 *)pCopy;
+		for(count = size; count > 0; count--)
+		{
+			*pDst++ = *pSrc++;
+		}
+
+		SNAPSHOT_BARRIER();
+	} while(sequence != pSnap->Sequence);
+}
@@ -0,0 +1,74 @@
+/**
+ * @file stackmon.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief tasks stack usage monitor
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include "stackmon.h"
+#include "uart.h"
+#include "format.h"
+
+/**
+ * @brief monitored task
+ *
+ */
+typedef struct
+{
+	TaskHandle_t Task;
+	uint16 Size;
+} StackMon_Task_t;
+
+static StackMon_Task_t StackMon_Tasks[STACKMON_MAX_TASKS];
+static uint8 StackMon_Count = 0;
+
+/**
+ * @brief send a number followed by a separator
+ *
+ */
+static void StackMon_sendNumber(uint16 number, const char * sep)
+{
+	char buff[FORMAT_U16_DIGITS + 1];
+
+	buff[Format_u16(number, buff, 0)] = '\0';
+	UART_sendString(buff);
+	UART_sendString(sep);
+}
+
+ERROR_t StackMon_add(TaskHandle_t task, uint16 size)
+{
+	if((NULL == task) || (StackMon_Count >= STACKMON_MAX_TASKS))
+	{
+		return E_NOK;
+	}
+
+	StackMon_Tasks[StackMon_Count].Task = task;
+	StackMon_Tasks[StackMon_Count].Size = size;
+	StackMon_Count++;
+
+	return E_OK;
+}
+
+void StackMon_report(void)
+{
+	uint8 k;
+	uint16 used;
+
+	UART_sendString("task size used rec\r\n");
+
+	for(k = 0; k < StackMon_Count; k++)
+	{
+		/* the stack bytes still holding the fill pattern were never used */
+		used = StackMon_Tasks[k].Size - uxTaskGetStackHighWaterMark(StackMon_Tasks[k].Task);
+
+		UART_sendString(pcTaskGetTaskName(StackMon_Tasks[k].Task));
+		UART_sendString(" ");
+		StackMon_sendNumber(StackMon_Tasks[k].Size, " ");
+		StackMon_sendNumber(used, " ");
+		StackMon_sendNumber(used + STACKMON_MARGIN, "\r\n");
+	}
+}
@@ -0,0 +1,237 @@
+/**
+ * @file trace.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief kernel trace recorder, the events are kept in a ring buffer and sent
+ * by the idle hook through the uart TX interrupt, tools/tracedec.c decodes them
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "trace.h"
+#include "uart.h"
+
+#if TRACE_ENABLE == 1
+
+#if configGENERATE_RUN_TIME_STATS != 1
+	#error the trace time stamps are taken from the run time counter, set configGENERATE_RUN_TIME_STATS to 1
+#endif
+
+#define TRACE_MASK				(TRACE_BUFFER_EVENTS - 1)
+
+/* an event may need a SYNC and a LOST event in front of it */
+#define TRACE_MAX_PUT			3
+
+static uint8 Trace_Buffer[TRACE_BUFFER_EVENTS][TRACE_EVENT_SIZE];
+static uint8 Trace_Head = 0;
+static uint8 Trace_Tail = 0;
+
+/* events not recorded since the last LOST event */
+static uint8 Trace_Lost = 0;
+
+/* high 16 bits of the time of the last recorded event */
+static uint16 Trace_High = 0;
+static uint8 Trace_Synced = 0;
+
+static volatile uint8 Trace_Running = 0;
+
+/* a reply is being sent, no frame may go in the middle of it */
+static volatile uint8 Trace_Paused = 0;
+
+/**
+ * @brief add an event to the buffer, the caller checked there is room
+ *
+ */
+static void Trace_put(uint8 event, uint8 object, uint16 time)
+{
+	uint8 * pEvent = Trace_Buffer[Trace_Head];
+
+	pEvent[0] = event;
+	pEvent[1] = object;
+	pEvent[2] = (uint8)time;
+	pEvent[3] = (uint8)(time >> 8);
+	Trace_Head = (Trace_Head + 1) & TRACE_MASK;
+}
+
+void Trace_record(uint8 event, uint8 object)
+{
+	uint32 now;
+	uint8 used;
+
+	if(!Trace_Running)
+	{
+		return;
+	}
+
+	/* the kernel calls the hooks from tasks, interrupts and the context switch,
+	 * the AVR port critical section saves and restores the interrupt flag so it
+	 * is safe in all of them */
+	portENTER_CRITICAL();
+
+	used = (Trace_Head - Trace_Tail) & TRACE_MASK;
+
+	/* one entry is kept free to tell a full buffer from an empty one */
+	if((TRACE_BUFFER_EVENTS - 1 - used) < TRACE_MAX_PUT)
+	{
+		if(Trace_Lost < 0xff)
+		{
+			Trace_Lost++;
+		}
+	}
+	else
+	{
+		now = portGET_RUN_TIME_COUNTER_VALUE();
+
+		/* the events only hold the low 16 bits of the time (524 ms) */
+		if(!Trace_Synced || (Trace_High != (uint16)(now >> 16)))
+		{
+			Trace_High = (uint16)(now >> 16);
+			Trace_Synced = 1;
+			Trace_put(TRACE_EV_SYNC, 0, Trace_High);
+		}
+
+		if(Trace_Lost)
+		{
+			Trace_put(TRACE_EV_LOST, Trace_Lost, (uint16)now);
+			Trace_Lost = 0;
+		}
+
+		Trace_put(event, object, (uint16)now);
+	}
+
+	portEXIT_CRITICAL();
+}
+
+void Trace_start(void)
+{
+	portENTER_CRITICAL();
+	Trace_Head = 0;
+	Trace_Tail = 0;
+	Trace_Lost = 0;
+	Trace_Synced = 0;
+	Trace_Running = 1;
+	portEXIT_CRITICAL();
+}
+
+void Trace_stop(void)
+{
+	Trace_Running = 0;
+}
+
+uint8 Trace_isRunning(void)
+{
+	return Trace_Running;
+}
+
+void Trace_pause(void)
+{
+	Trace_Paused = 1;
+}
+
+void Trace_resume(void)
+{
+	Trace_Paused = 0;
+}
+
+void Trace_flush(void)
+{
+	uint8 frame[TRACE_FRAME_SIZE(TRACE_FRAME_EVENTS)];
+	uint8 count;
+	uint8 tail;
+	uint8 sum;
+	uint8 sent;
+	uint8 k;
+	uint8 i;
+
+	/* the idle task runs when the reply waits for room in the uart */
+	while(!Trace_Paused)
+	{
+		/* copy the oldest events, they stay in the buffer until they are sent */
+		portENTER_CRITICAL();
+		count = (Trace_Head - Trace_Tail) & TRACE_MASK;
+		tail = Trace_Tail;
+		if(count > TRACE_FRAME_EVENTS)
+		{
+			count = TRACE_FRAME_EVENTS;
+		}
+		for(k = 0; k < count; k++)
+		{
+			for(i = 0; i < TRACE_EVENT_SIZE; i++)
+			{
+				frame[2 + (k * TRACE_EVENT_SIZE) + i] = Trace_Buffer[(tail + k) & TRACE_MASK][i];
+			}
+		}
+		portEXIT_CRITICAL();
+
+		if(0 == count)
+		{
+			return;
+		}
+
+		frame[0] = TRACE_FRAME_START;
+		frame[1] = count;
+		sum = 0;
+		for(k = 1; k < (TRACE_FRAME_SIZE(count) - 1); k++)
+		{
+			sum += frame[k];
+		}
+		frame[TRACE_FRAME_SIZE(count) - 1] = sum;
+
+		/* the frame goes whole or waits for the next call, a reply that
+		 * started since the loop test holds it back too */
+		portENTER_CRITICAL();
+		sent = !Trace_Paused && (E_OK == UART_writeFrame(frame, TRACE_FRAME_SIZE(count)));
+
+		/* only this function moves the tail, unless Trace_start cleared the
+		 * buffer while the frame was being made */
+		if(sent && (tail == Trace_Tail))
+		{
+			Trace_Tail = (tail + count) & TRACE_MASK;
+		}
+		portEXIT_CRITICAL();
+
+		if(!sent)
+		{
+			return;
+		}
+	}
+}
+
+#else
+
+void Trace_record(uint8 event, uint8 object)
+{
+	(void)event;
+	(void)object;
+}
+
+void Trace_start(void)
+{
+}
+
+void Trace_stop(void)
+{
+}
+
+uint8 Trace_isRunning(void)
+{
+	return 0;
+}
+
+void Trace_pause(void)
+{
+}
+
+void Trace_resume(void)
+{
+}
+
+void Trace_flush(void)
+{
+}
+
+#endif /* TRACE_ENABLE */
@@ -0,0 +1,113 @@
+/**
+ * @file trend.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief bargraph of the last readings drawn with lcd glyphs
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include "trend.h"
+
+/**
+ * @brief bar height of a reading, TREND_THRESHOLD_LEVEL at the threshold,
+ * rounded and limited to the glyph height
+ *
+ */
+static uint8 Trend_level(uint8 value, uint8 threshold)
+{
+	uint16 scaled = (uint16)value * TREND_THRESHOLD_LEVEL;
+	uint16 sum = 0;
+	uint8 level = 0;
+
+	/* scaled / threshold by adding, at most LCD_GLYPH_ROWS steps */
+	while((level < LCD_GLYPH_ROWS) && ((sum + (threshold >> 1)) <= scaled))
+	{
+		sum += threshold;
+		level++;
+	}
+
+	return level;
+}
+
+void Trend_init(Trend_t * pTrend, uint8 firstGlyph)
+{
+	pTrend->Head = 0;
+	pTrend->Count = 0;
+	pTrend->FirstGlyph = firstGlyph;
+}
+
+void Trend_add(Trend_t * pTrend, uint8 value)
+{
+	uint8 index;
+
+	if(pTrend->Count < TREND_SAMPLES)
+	{
+		/* not full yet, the oldest is at 0 */
+		pTrend->Samples[pTrend->Count] = value;
+		pTrend->Count++;
+	}
+	else
+	{
+		/* the newest takes the place of the oldest */
+		index = pTrend->Head;
+		pTrend->Samples[index] = value;
+		index++;
+		pTrend->Head = (index == TREND_SAMPLES) ? 0 : index;
+	}
+}
+
+void Trend_draw(const Trend_t * pTrend, uint8 threshold)
+{
+	uint8 bitmap[LCD_GLYPH_ROWS];
+	uint8 levels[5];
+	uint8 missing = TREND_SAMPLES - pTrend->Count;
+	uint8 position = 0;
+	uint8 index;
+	uint8 cell;
+	uint8 col;
+	uint8 row;
+
+	for(cell = 0; cell < TREND_CELLS; cell++)
+	{
+		/* the readings of the cell, the empty columns before the first
+		 * reading have no bar */
+		for(col = 0; col < 5; col++)
+		{
+			if(position < missing)
+			{
+				levels[col] = 0;
+			}
+			else
+			{
+				index = pTrend->Head + (position - missing);
+				if(index >= TREND_SAMPLES)
+				{
+					index -= TREND_SAMPLES;
+				}
+				levels[col] = Trend_level(pTrend->Samples[index], threshold);
+			}
+			position++;
+		}
+
+		/* rows from the top, bit 4 is the left column */
+		for(row = 0; row < LCD_GLYPH_ROWS; row++)
+		{
+			bitmap[row] = 0;
+			for(col = 0; col < 5; col++)
+			{
+				if(levels[col] >= (LCD_GLYPH_ROWS - row))
+				{
+					bitmap[row] |= (0x10 >> col);
+				}
+			}
+		}
+
+		/* dotted threshold line on the top row of a bar at the threshold */
+		bitmap[LCD_GLYPH_ROWS - TREND_THRESHOLD_LEVEL] |= 0x15;
+
+		LCD_defineGlyph(pTrend->FirstGlyph + cell, bitmap);
+	}
+}
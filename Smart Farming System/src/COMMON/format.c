@@ -0,0 +1,98 @@
+/**
+ * @file format.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief number to text formatting
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include "format.h"
+
+/* powers of ten of the digits before the units digit */
+static const uint16 Format_Powers[FORMAT_U16_DIGITS - 1] = {10000, 1000, 100, 10};
+
+/**
+ * @brief write the digits after the padding spaces
+ *
+ */
+static uint8 Format_pad(const char * pDigits, uint8 count, char * pText, uint8 width)
+{
+	uint8 i = 0;
+
+	while(width > count)
+	{
+		pText[i++] = ' ';
+		width--;
+	}
+	while(count)
+	{
+		pText[i++] = *pDigits++;
+		count--;
+	}
+
+	return i;
+}
+
+uint8 Format_u8(uint8 value, char * pText, uint8 width)
+{
+	char digits[FORMAT_U8_DIGITS];
+	uint8 count = 0;
+	uint8 digit;
+
+	/* hundreds and tens, leading zeros are not written */
+	digit = '0';
+	while(value >= 100)
+	{
+		value -= 100;
+		digit++;
+	}
+	if('0' != digit)
+	{
+		digits[count++] = digit;
+	}
+
+	digit = '0';
+	while(value >= 10)
+	{
+		value -= 10;
+		digit++;
+	}
+	if(count || ('0' != digit))
+	{
+		digits[count++] = digit;
+	}
+
+	digits[count++] = '0' + value;
+
+	return Format_pad(digits, count, pText, width);
+}
+
+uint8 Format_u16(uint16 value, char * pText, uint8 width)
+{
+	char digits[FORMAT_U16_DIGITS];
+	uint8 count = 0;
+	uint8 digit;
+	uint8 k;
+
+	/* each digit takes at most 9 subtractions */
+	for(k = 0; k < (FORMAT_U16_DIGITS - 1); k++)
+	{
+		digit = '0';
+		while(value >= Format_Powers[k])
+		{
+			value -= Format_Powers[k];
+			digit++;
+		}
+		if(count || ('0' != digit))
+		{
+			digits[count++] = digit;
+		}
+	}
+
+	digits[count++] = '0' + value;
+
+	return Format_pad(digits, count, pText, width);
+}
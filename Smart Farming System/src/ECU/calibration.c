@@ -0,0 +1,188 @@
+/**
+ * @file calibration.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief per sensor calibration tables with piecewise linear interpolation
+ * @version 0.1
+ * @date 2021-05-12
+ * 
+ * @copyright Copyright (c) 2021
+ * 
+ */
+
+#include <avr/eeprom.h>
+#include <util/atomic.h>
+#include "string.h"
+#include "calibration.h"
+
+/* marks a written EEPROM image, changed when the layout changes */
+#define CAL_MAGIC	0xCA
+
+/**
+ * @brief calibration image stored in EEPROM
+ * 
+ */
+typedef struct
+{
+	uint8 Magic;
+	uint16 Points[SENSORS_COUNT][CAL_POINTS];
+	uint8 Checksum;
+} Calibration_Image_t;
+
+static Calibration_Image_t EEMEM Calibration_Eeprom;
+
+/* working copy of the tables */
+static uint16 Calibration_Tables[SENSORS_COUNT][CAL_POINTS];
+
+/* steps of a save, the bytes of the tables then the checksum and the magic */
+#define CAL_SAVE_CHECKSUM	(sizeof(Calibration_Tables))
+#define CAL_SAVE_MAGIC		(CAL_SAVE_CHECKSUM + 1)
+#define CAL_SAVE_DONE		(CAL_SAVE_CHECKSUM + 2)
+
+/* next step of the save done by Calibration_flush(), a new table starts
+ * the save again from the first byte */
+static volatile uint8 Calibration_SaveStep = CAL_SAVE_DONE;
+
+/**
+ * @brief 8 bit sum of the magic and the tables
+ * 
+ * @param pData tables to sum
+ * @param len size of the tables in bytes
+ * @return uint8 checksum
+ */
+static uint8 Calibration_checksum(const void * pData, uint8 len)
+{
+	const uint8 * pBytes = (const uint8 *)pData;
+	uint8 sum = CAL_MAGIC;
+	uint8 i;
+
+	for(i = 0; i < len; i++)
+	{
+		sum += pBytes[i];
+	}
+
+	return sum;
+}
+
+void Calibration_init(void)
+{
+	Calibration_Image_t image;
+	uint8 sensor, point;
+
+	eeprom_read_block(&image, &Calibration_Eeprom, sizeof(image));
+
+	if((CAL_MAGIC == image.Magic) && (Calibration_checksum(image.Points, sizeof(image.Points)) == image.Checksum))
+	{
+		memcpy(Calibration_Tables, image.Points, sizeof(Calibration_Tables));
+	}
+	else
+	{
+		/* blank or corrupted EEPROM, identity tables */
+		for(sensor = 0; sensor < SENSORS_COUNT; sensor++)
+		{
+			for(point = 0; point < CAL_POINTS; point++)
+			{
+				Calibration_Tables[sensor][point] = (uint16)point << CAL_SEGMENT_BITS;
+			}
+		}
+	}
+}
+
+uint16 Calibration_apply(uint8 sensor, uint16 adc)
+{
+	/* breakpoint index and position inside the segment */
+	uint8 segment = (adc >> CAL_SEGMENT_BITS) & (CAL_POINTS - 2);
+	uint16 fraction = adc & ((1 << CAL_SEGMENT_BITS) - 1);
+	uint16 y0, y1;
+
+	/* both points must come from the same table if it is replaced meanwhile */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		y0 = Calibration_Tables[sensor][segment];
+		y1 = Calibration_Tables[sensor][segment + 1];
+	}
+
+	/* y0 + (y1 - y0) * fraction, no branches so the time does not depend on the value */
+	return (uint16)((sint32)y0 + ((((sint32)y1 - (sint32)y0) * fraction) >> CAL_SEGMENT_BITS));
+}
+
+ERROR_t Calibration_setTable(uint8 sensor, const uint16 * pPoints)
+{
+	uint8 point;
+
+	if(sensor >= SENSORS_COUNT)
+	{
+		return E_NOK;
+	}
+	for(point = 0; point < CAL_POINTS; point++)
+	{
+		if(pPoints[point] > CAL_MAX_VALUE)
+		{
+			return E_NOK;
+		}
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		memcpy(Calibration_Tables[sensor], pPoints, sizeof(Calibration_Tables[sensor]));
+		Calibration_SaveStep = 0;
+	}
+
+	return E_OK;
+}
+
+void Calibration_flush(void)
+{
+	uint8 * pAddress;
+	uint8 step;
+	uint8 value = 0;
+
+	/* an EEPROM write takes about 8.5 ms, only one is started per call and
+	 * the unchanged bytes are skipped */
+	while(eeprom_is_ready())
+	{
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			step = Calibration_SaveStep;
+			if(step < CAL_SAVE_DONE)
+			{
+				Calibration_SaveStep = step + 1;
+			}
+			if(step < CAL_SAVE_CHECKSUM)
+			{
+				value = ((const uint8 *)Calibration_Tables)[step];
+			}
+		}
+
+		/* a table set meanwhile starts the save again, so a byte of the
+		 * previous one written here is written again */
+		if(step < CAL_SAVE_CHECKSUM)
+		{
+			pAddress = (uint8 *)Calibration_Eeprom.Points + step;
+		}
+		else if(CAL_SAVE_CHECKSUM == step)
+		{
+			pAddress = &Calibration_Eeprom.Checksum;
+			value = Calibration_checksum(Calibration_Tables, sizeof(Calibration_Tables));
+		}
+		else if(CAL_SAVE_MAGIC == step)
+		{
+			pAddress = &Calibration_Eeprom.Magic;
+			value = CAL_MAGIC;
+		}
+		else
+		{
+			return;
+		}
+
+		if(eeprom_read_byte(pAddress) != value)
+		{
+			eeprom_write_byte(pAddress, value);
+			return;
+		}
+	}
+}
+
+uint8 Calibration_isSaving(void)
+{
+	return (Calibration_SaveStep < CAL_SAVE_DONE);
+}
@@ -9,11 +9,65 @@
  * 
  */
 
-#include "stdlib.h"
+#include "string.h"
+#include <util/atomic.h>
 #include "lcd.h"
+#include "format.h"
+#include "lcd_timing.h"
+
+/* lcd address of the first column in each row */
+static const uint8 LCD_RowAddress[LCD_ROWS] = {0x00, 0x40, 0x14, 0x54};
+
+/* row that follows the last column of each row, the same order
+ * the lcd address counter uses 0x13 -> 0x14 -> 0x27 -> 0x40 -> 0x53 -> 0x54 */
+static const uint8 LCD_NextRow[LCD_ROWS] = {2, 3, 1, 0};
+
+/* frame buffer written by the application, row after row */
+static uint8 LCD_FrameBuffer[LCD_ROWS * LCD_COLS];
+
+/* one bit for each frame buffer cell that is not sent to the lcd yet */
+static uint8 LCD_DirtyCells[(LCD_ROWS * LCD_COLS) / 8];
+
+/* set when the frame buffer or the cursor changes */
+static volatile uint8 LCD_FlushPending = 0;
+
+/* frame buffer cursor */
+static uint8 LCD_CursorRow = 0;
+static uint8 LCD_CursorCol = 0;
+static volatile uint8 LCD_CursorAddress = 0;
+
+/* requested and current cursor mode */
+static volatile uint8 LCD_CursorMode = CURSOR_OFF;
+static uint8 LCD_ShownCursorMode = CURSOR_OFF;
+
+/* current lcd address counter */
+static uint8 LCD_Address = 0;
+
+/* address counter value after a glyph upload, it points to the CGRAM and
+ * matches no display address */
+#define LCD_ADDRESS_CGRAM	0xFF
+
+/* copy of the glyphs written by the application, the ones the lcd has
+ * (valid) and the ones not sent yet (dirty), one bit per glyph */
+static uint8 LCD_Glyphs[LCD_GLYPHS][LCD_GLYPH_ROWS];
+static uint8 LCD_ValidGlyphs = 0;
+static uint8 LCD_DirtyGlyphs = 0;
+
+/* bus transfers, read by other tasks so they are changed atomically */
+static LCD_Stats_t LCD_Stats;
+
+/**
+ * @brief send data byte to lcd
+ * 
+ * @param data byte to write in the lcd ram
+ */
+static void LCD_sendData(uint8 data);
 
 void LCD_init(void)
 {
+	/* wait for the lcd internal reset after power on > 40 ms */
+	_delay_ms(40);
+
 	/* Configure the control pins(E,RS,RW) as output pins */
 	LCD_CTRL_PORT_DIR |= (1<<E) | (1<<RS) | (1<<RW); 
 	
@@ -41,118 +95,195 @@ void LCD_init(void)
 
 	/* clear LCD at the beginning */
 	LCD_sendCommand(CLEAR_COMMAND); 
+
+	/* frame buffer matches the cleared lcd */
+	memset(LCD_FrameBuffer, ' ', sizeof(LCD_FrameBuffer));
+	memset(LCD_DirtyCells, 0, sizeof(LCD_DirtyCells));
+	LCD_Address = 0;
+
+	/* the CGRAM content is random after power on */
+	LCD_ValidGlyphs = 0;
+	LCD_DirtyGlyphs = 0;
 }
 
-void LCD_sendCommand(uint8 command)
+/**
+ * @brief wait until the lcd is ready for the next transfer
+ * 
+ */
+static void LCD_waitReady(void)
 {
-	/* Instruction Mode RS = 0 */
-	CLEAR_BIT(LCD_CTRL_PORT,RS); 
-	/* write data to LCD so RW = 0 */
-	CLEAR_BIT(LCD_CTRL_PORT,RW);
-	/* delay for processing Tas = 50 ns */
-	_delay_ms(1); 
-	/* Enable LCD E = 1 */
-	SET_BIT(LCD_CTRL_PORT,E); 
-	/* delay for processing Tpw - Tdws = 190 ns */
-	_delay_ms(1); 
+#if (LCD_USE_BUSY_FLAG == 1)
+	uint16 polls = 0;
+	uint8 busy;
+
+	/* data bus as input to read the busy flag on DB7 */
 	#if (DATA_BITS_MODE == 4)
-		/* out the highest 4 bits of the required command to the data bus D4 --> D7 */
 		#ifdef UPPER_PORT_PINS
-			LCD_DATA_PORT = (command & 0xF0); 
-		#else 
-			LCD_DATA_PORT = ((command >> 4) & 0x0F);
+			LCD_DATA_PORT_DIR &= 0x0F;
+		#else
+			LCD_DATA_PORT_DIR &= 0xF0;
+		#endif
+	#elif (DATA_BITS_MODE == 8)
+		LCD_DATA_PORT_DIR = 0x00;
+	#endif
+
+	/* Instruction Mode RS = 0, read from LCD so RW = 1 */
+	CLEAR_BIT(LCD_CTRL_PORT,RS);
+	SET_BIT(LCD_CTRL_PORT,RW);
+	LCD_DELAY_NS(LCD_T_AS_NS);
+
+	do
+	{
+		/* busy flag is valid Tddr after E rise */
+		SET_BIT(LCD_CTRL_PORT,E);
+		LCD_DELAY_NS(LCD_T_DDR_NS);
+		#if (DATA_BITS_MODE == 4)
+			#ifdef UPPER_PORT_PINS
+				busy = BIT_IS_SET(PINC,7);
+			#else
+				busy = BIT_IS_SET(PINC,3);
+			#endif
+			LCD_DELAY_NS(LCD_T_PW_EH_NS - LCD_T_DDR_NS);
+			CLEAR_BIT(LCD_CTRL_PORT,E);
+			LCD_DELAY_NS(LCD_T_CYCLE_E_NS - LCD_T_PW_EH_NS);
+			/* the low nibble (address counter) has to be clocked out too */
+			SET_BIT(LCD_CTRL_PORT,E);
+			LCD_DELAY_NS(LCD_T_PW_EH_NS);
+		#elif (DATA_BITS_MODE == 8)
+			busy = BIT_IS_SET(PINC,7);
+			LCD_DELAY_NS(LCD_T_PW_EH_NS - LCD_T_DDR_NS);
 		#endif
-			
-		/* delay for processing Tdsw = 100ns */
-		_delay_ms(1); 
-		/* disable LCD E=0 */
-		CLEAR_BIT(LCD_CTRL_PORT,E); 
-		/* delay for processing Th = 13ns */
-		_delay_ms(1); 
-		/* Enable LCD E=1 */
-		SET_BIT(LCD_CTRL_PORT,E); 
-		/* delay for processing Tpw - Tdws = 190ns */
-		_delay_ms(1); 
-		
-		/* out the lowest 4 bits of the required command to the data bus D4 --> D7 */
+		CLEAR_BIT(LCD_CTRL_PORT,E);
+		LCD_DELAY_NS(LCD_T_CYCLE_E_NS - LCD_T_PW_EH_NS);
+		polls++;
+	} while(busy && (polls < LCD_BUSY_POLL_MAX));
+
+	/* back to write mode */
+	CLEAR_BIT(LCD_CTRL_PORT,RW);
+	#if (DATA_BITS_MODE == 4)
 		#ifdef UPPER_PORT_PINS
-			LCD_DATA_PORT = (command << 4) & 0xF0; 
-		#else 
-			LCD_DATA_PORT = (command & 0x0F);
+			LCD_DATA_PORT_DIR |= 0xF0;
+		#else
+			LCD_DATA_PORT_DIR |= 0x0F;
 		#endif
-		
-		/* delay for processing Tdsw = 100ns */
-		_delay_ms(1); 
-		/* disable LCD E=0 */
-		CLEAR_BIT(LCD_CTRL_PORT,E); 
-		/* delay for processing Th = 13ns */
-		_delay_ms(1); 
 	#elif (DATA_BITS_MODE == 8)
-		/* out the required command to the data bus D0 --> D7 */ 
-		LCD_DATA_PORT = command; 
-		/* delay for processing Tdsw = 100 ns */
-		_delay_ms(1); 
-		/* disable LCD E = 0 */
-		CLEAR_BIT(LCD_CTRL_PORT,E); 
-		/* delay for processing Th = 13 ns */
-		_delay_ms(1); 
-	#endif	
+		LCD_DATA_PORT_DIR = 0xFF;
+	#endif
+#endif
 }
 
-void LCD_displayCharacter(uint8 data)
+/**
+ * @brief clock one bus transfer (a byte in 8-bit mode or a nibble in 4-bit mode) with E
+ * 
+ * @param value value to put on the data bus
+ */
+static void LCD_strobe(uint8 value)
 {
-	/* Data Mode RS = 1 */
-	SET_BIT(LCD_CTRL_PORT,RS); 
-	/* write data to LCD so RW = 0 */
-	CLEAR_BIT(LCD_CTRL_PORT,RW); 
-	/* delay for processing Tas = 50 ns */
-	_delay_ms(1); 
 	/* Enable LCD E = 1 */
-	SET_BIT(LCD_CTRL_PORT,E); 
-	/* delay for processing Tpw - Tdws = 190 ns */
-	_delay_ms(1);
+	SET_BIT(LCD_CTRL_PORT,E);
+	/* out the value to the data bus */
+	LCD_DATA_PORT = value;
+	/* E high for Tpw, covers Tdsw = 80 ns too */
+	LCD_DELAY_NS(LCD_T_PW_EH_NS);
+	/* disable LCD E = 0, data is latched on the falling edge */
+	CLEAR_BIT(LCD_CTRL_PORT,E);
+	/* E low until the end of the E cycle, covers Th = 10 ns too */
+	LCD_DELAY_NS(LCD_T_CYCLE_E_NS - LCD_T_PW_EH_NS);
+}
+
+/**
+ * @brief write command or data byte to the lcd
+ * 
+ * @param rs 0 for command, 1 for data
+ * @param value byte to write
+ */
+static void LCD_write(uint8 rs, uint8 value)
+{
+	LCD_waitReady();
+
+	/* Instruction Mode RS = 0 or Data Mode RS = 1 */
+	if(rs)
+	{
+		SET_BIT(LCD_CTRL_PORT,RS);
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			LCD_Stats.Data++;
+		}
+	}
+	else
+	{
+		CLEAR_BIT(LCD_CTRL_PORT,RS);
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			LCD_Stats.Commands++;
+		}
+	}
+	/* write data to LCD so RW = 0 */
+	CLEAR_BIT(LCD_CTRL_PORT,RW);
+	/* delay for processing Tas = 40 ns */
+	LCD_DELAY_NS(LCD_T_AS_NS);
+
 	#if (DATA_BITS_MODE == 4)
-		/* out the highest 4 bits of the required command to the data bus D4 --> D7 */
+		/* out the highest 4 bits then the lowest 4 bits to the data bus D4 --> D7 */
 		#ifdef UPPER_PORT_PINS
-			LCD_DATA_PORT = (data & 0xF0); 
+			LCD_strobe((LCD_DATA_PORT & 0x0F) | (value & 0xF0));
+			LCD_strobe((LCD_DATA_PORT & 0x0F) | ((value << 4) & 0xF0));
 		#else 
-			LCD_DATA_PORT = ((data >> 4) & 0x0F);
+			LCD_strobe((LCD_DATA_PORT & 0xF0) | ((value >> 4) & 0x0F));
+			LCD_strobe((LCD_DATA_PORT & 0xF0) | (value & 0x0F));
 		#endif
-		
-		/* delay for processing Tdsw = 100ns */
-		_delay_ms(1); 
-		/* disable LCD E=0 */
-		CLEAR_BIT(LCD_CTRL_PORT,E);
-		/* delay for processing Th = 13ns */
-		_delay_ms(1); 
-		/* Enable LCD E=1 */
-		SET_BIT(LCD_CTRL_PORT,E); 
-		/* delay for processing Tpw - Tdws = 190ns */
-		_delay_ms(1); 
-		
-		/* out the lowest 4 bits of the required data to the data bus D4 --> D7 */
-		#ifdef UPPER_PORT_PINS
-			LCD_DATA_PORT = (data << 4) & 0xF0; 
-		#else 
-			LCD_DATA_PORT = (data & 0x0F);
-		#endif
-		
-		/* delay for processing Tdsw = 100ns */
-		_delay_ms(1); 
-		/* disable LCD E=0 */
-		CLEAR_BIT(LCD_CTRL_PORT,E); 
-		/* delay for processing Th = 13ns */
-		_delay_ms(1); 
 	#elif (DATA_BITS_MODE == 8)
-		/* out the required data to the data bus D0 --> D7 */
-		LCD_DATA_PORT = data; 
-		/* delay for processing Tdsw = 100 ns */
-		_delay_ms(1); 
-		/* disable LCD E = 0 */
-		CLEAR_BIT(LCD_CTRL_PORT,E); 
-		/* delay for processing Th = 13 ns */
-		_delay_ms(1); 
-	#endif	
+		/* out the byte to the data bus D0 --> D7 */
+		LCD_strobe(value);
+	#endif
+
+	#if (LCD_USE_BUSY_FLAG == 0)
+		/* no busy flag so wait the execution time */
+		_delay_us(LCD_T_EXEC_US);
+	#endif
+}
+
+void LCD_sendCommand(uint8 command)
+{
+	LCD_write(0, command);
+
+	#if (LCD_USE_BUSY_FLAG == 0)
+		if(command < 0x04)
+		{
+			/* clear (0x01) and return home (0x02) take longer */
+			_delay_us(LCD_T_EXEC_CLEAR_US - LCD_T_EXEC_US);
+		}
+	#endif
+}
+
+static void LCD_sendData(uint8 data)
+{
+	LCD_write(1, data);
+}
+
+void LCD_displayCharacter(uint8 data)
+{
+	uint8 index = (LCD_CursorRow * LCD_COLS) + LCD_CursorCol;
+
+	/* only cells that really change need to be sent to the lcd */
+	if(LCD_FrameBuffer[index] != data)
+	{
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			LCD_FrameBuffer[index] = data;
+			SET_BIT(LCD_DirtyCells[index >> 3], (index & 0x07));
+		}
+		LCD_FlushPending = 1;
+	}
+
+	/* move the cursor the same way the lcd address counter does */
+	LCD_CursorCol++;
+	if(LCD_CursorCol == LCD_COLS)
+	{
+		LCD_CursorCol = 0;
+		LCD_CursorRow = LCD_NextRow[LCD_CursorRow];
+	}
+	LCD_CursorAddress = LCD_RowAddress[LCD_CursorRow] + LCD_CursorCol;
 }
 
 void LCD_displayString(const char *Str)
@@ -174,34 +305,16 @@ void LCD_displayString(const char *Str)
 
 void LCD_goToRowColumn(uint8 row,uint8 col)
 {
-	uint8 Address = 0;
-	
-	/* first of all calculate the required address */
-	switch(row)
-	{	
-		/* row 0 */
-		case 0: 
-				Address=col;
-				break;
-		
-		/* row 1 */
-		case 1:
-				Address=col+0x40;
-				break;
-
-		/* row 2 */
-		case 2:
-				Address=col+0x14;
-				break;
-		
-		/* row 3 */
-		case 3:
-				Address=col+0x54;
-				break;
-	}					
-	/* to write to a specific address in the LCD 
-	 * we need to apply the corresponding command 0b10000000+Address */
-	LCD_sendCommand(Address | SET_CURSOR_LOCATION); 
+	/* move the frame buffer cursor, the lcd cursor is moved by LCD_flush() */
+	LCD_CursorRow = row;
+	LCD_CursorCol = col;
+	LCD_CursorAddress = LCD_RowAddress[row] + col;
+
+	/* a visible cursor has to be moved on the lcd too */
+	if(LCD_CursorMode != CURSOR_OFF)
+	{
+		LCD_FlushPending = 1;
+	}
 }
 
 void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str)
@@ -214,15 +327,217 @@ void LCD_displayStringRowColumn(uint8 row,uint8 col,const char *Str)
 
 void LCD_intgerToString(int data)
 {
-	/* String to hold the asci result */
-	char buff[6]; 
-	/* 10 for decimal */
-	itoa(data,buff,10); 
-	LCD_displayString(buff);
+	if(data < 0)
+	{
+		LCD_displayCharacter('-');
+		/* negated as unsigned so that -32768 does not overflow */
+		LCD_displayNumber(0u - (uint16)data, 0);
+	}
+	else
+	{
+		LCD_displayNumber((uint16)data, 0);
+	}
+}
+
+void LCD_displayNumber(uint16 value, uint8 width)
+{
+	char buff[FORMAT_U16_DIGITS];
+	uint8 length;
+	uint8 i;
+
+	length = Format_u16(value, buff, 0);
+
+	/* the padding goes straight to the frame buffer, no buffer of the width */
+	while(width > length)
+	{
+		LCD_displayCharacter(' ');
+		width--;
+	}
+	for(i = 0; i < length; i++)
+	{
+		LCD_displayCharacter(buff[i]);
+	}
 }
 
 void LCD_clearScreen(void)
 {
-	/* clear display */ 
-	LCD_sendCommand(CLEAR_COMMAND); 
-}	 
+	uint8 i;
+
+	/* clear the frame buffer, only non empty cells will be sent to the lcd */
+	LCD_goToRowColumn(0,0);
+	for(i = 0; i < (LCD_ROWS * LCD_COLS); i++)
+	{
+		LCD_displayCharacter(' ');
+	}
+}
+
+void LCD_setCursorMode(uint8 mode)
+{
+	LCD_CursorMode = mode;
+	LCD_FlushPending = 1;
+}
+
+ERROR_t LCD_defineGlyph(uint8 index, const uint8 * pBitmap)
+{
+	uint8 glyph;
+
+	if((index >= LCD_GLYPHS) || (NULL_PTR == pBitmap))
+	{
+		return E_NOK;
+	}
+	glyph = (1 << index);
+
+	/* only the application writes the copy, so it is compared without a lock */
+	if((LCD_ValidGlyphs & glyph) && (0 == memcmp(LCD_Glyphs[index], pBitmap, LCD_GLYPH_ROWS)))
+	{
+		return E_OK;
+	}
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		memcpy(LCD_Glyphs[index], pBitmap, LCD_GLYPH_ROWS);
+		LCD_ValidGlyphs |= glyph;
+		LCD_DirtyGlyphs |= glyph;
+	}
+	LCD_FlushPending = 1;
+
+	return E_OK;
+}
+
+/**
+ * @brief send the changed glyphs to the CGRAM
+ * 
+ */
+static void LCD_flushGlyphs(void)
+{
+	uint8 bitmap[LCD_GLYPH_ROWS];
+	uint8 index;
+	uint8 row;
+	uint8 dirty;
+
+	for(index = 0; index < LCD_GLYPHS; index++)
+	{
+		/* taken with its dirty bit cleared in one step like the cells */
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			dirty = LCD_DirtyGlyphs & (1 << index);
+			if(dirty)
+			{
+				LCD_DirtyGlyphs &= ~dirty;
+				memcpy(bitmap, LCD_Glyphs[index], LCD_GLYPH_ROWS);
+			}
+		}
+
+		if(dirty)
+		{
+			/* the CGRAM address counter moves to the next row by itself */
+			LCD_sendCommand(SET_CGRAM_ADDRESS | (index << 3));
+			for(row = 0; row < LCD_GLYPH_ROWS; row++)
+			{
+				LCD_sendData(bitmap[row]);
+			}
+			LCD_Address = LCD_ADDRESS_CGRAM;
+
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				LCD_Stats.Glyphs++;
+			}
+		}
+	}
+}
+
+void LCD_flush(void)
+{
+	uint8 row, col;
+	uint8 index = 0;
+	uint8 address;
+	uint8 dirty;
+	uint8 data = 0;
+	uint8 mode;
+	uint16 transfers;
+
+	if(0 == LCD_FlushPending)
+	{
+		return;
+	}
+	/* cleared first so that writes done while flushing trigger the next flush */
+	LCD_FlushPending = 0;
+
+	/* only the flush writes the lcd once the scheduler runs */
+	transfers = LCD_Stats.Commands + LCD_Stats.Data;
+
+	/* glyphs first, the cells showing them are then right at once and the
+	 * cursor command of the first cell brings the address back to the DDRAM */
+	if(LCD_DirtyGlyphs)
+	{
+		LCD_flushGlyphs();
+	}
+
+	for(row = 0; row < LCD_ROWS; row++)
+	{
+		address = LCD_RowAddress[row];
+		for(col = 0; col < LCD_COLS; col++)
+		{
+			/* take the cell and clear its dirty bit in one step as the 
+			 * application may preempt the flush and rewrite the same cell */
+			ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+			{
+				dirty = LCD_DirtyCells[index >> 3] & (1 << (index & 0x07));
+				if(dirty)
+				{
+					LCD_DirtyCells[index >> 3] &= ~dirty;
+					data = LCD_FrameBuffer[index];
+				}
+			}
+
+			if(dirty)
+			{
+				/* no cursor command needed when the cell follows the last written one */
+				if(LCD_Address != address)
+				{
+					LCD_sendCommand(address | SET_CURSOR_LOCATION);
+				}
+				LCD_sendData(data);
+				LCD_Address = address + 1;
+			}
+			index++;
+			address++;
+		}
+	}
+
+	mode = LCD_CursorMode;
+	if(mode != LCD_ShownCursorMode)
+	{
+		LCD_sendCommand(mode);
+		LCD_ShownCursorMode = mode;
+	}
+
+	/* put the visible cursor back to the frame buffer cursor */
+	if(mode != CURSOR_OFF)
+	{
+		address = LCD_CursorAddress;
+		if(LCD_Address != address)
+		{
+			LCD_sendCommand(address | SET_CURSOR_LOCATION);
+			LCD_Address = address;
+		}
+	}
+
+	transfers = (LCD_Stats.Commands + LCD_Stats.Data) - transfers;
+	if(transfers)
+	{
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+		{
+			LCD_Stats.Flushes++;
+			LCD_Stats.Last = transfers;
+		}
+	}
+}
+
+void LCD_getStats(LCD_Stats_t * pStats)
+{
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		*pStats = LCD_Stats;
+	}
+}
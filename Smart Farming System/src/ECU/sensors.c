@@ -9,17 +9,121 @@
  * 
  */
 
+#include <util/atomic.h>
 #include "sensors.h"
+#include "calibration.h"
 #include "adc.h"
 
+#if (SENSORS_FILTER_LEN & (SENSORS_FILTER_LEN - 1))
+	#error SENSORS_FILTER_LEN must be a power of 2
+#endif
+
+/* ADC channel of each sensor, ordered by the sensor index */
+static const uint8 Sensors_Channels[SENSORS_COUNT] = {TEMP_SENSOR_CH, HUMI_SENSOR_CH};
+
+/* moving average filter, updated from the ADC interrupt */
+static uint16 Sensors_History[SENSORS_COUNT][SENSORS_FILTER_LEN];
+static uint16 Sensors_FilterSum[SENSORS_COUNT];
+static uint8 Sensors_HistoryIndex = 0;
+static uint8 Sensors_Primed = 0;
+static uint8 Sensors_PublishCount = 0;
+
+/* last filtered value reported to the application */
+static uint16 Sensors_Reported[SENSORS_COUNT];
+
+static ADC_ScanCallback_t Sensors_Callback = NULL_PTR;
+
+/**
+ * @brief called from the ADC interrupt with a new decimated sample of each sensor
+ * 
+ */
+static void Sensors_ScanCallback(void)
+{
+	uint8 i, j;
+	uint16 sample;
+
+	for(i = 0; i < SENSORS_COUNT; i++)
+	{
+		sample = ADC_getSample(i);
+
+		if(0 == Sensors_Primed)
+		{
+			/* first sample fills the filter so it does not ramp up from zero */
+			for(j = 0; j < SENSORS_FILTER_LEN; j++)
+			{
+				Sensors_History[i][j] = sample;
+			}
+			Sensors_FilterSum[i] = sample * SENSORS_FILTER_LEN;
+		}
+		else
+		{
+			/* replace the oldest sample in the running sum */
+			Sensors_FilterSum[i] += sample - Sensors_History[i][Sensors_HistoryIndex];
+			Sensors_History[i][Sensors_HistoryIndex] = sample;
+		}
+	}
+	Sensors_Primed = 1;
+	Sensors_HistoryIndex = (Sensors_HistoryIndex + 1) & (SENSORS_FILTER_LEN - 1);
+
+	Sensors_PublishCount++;
+	if(SENSORS_PUBLISH_EVERY == Sensors_PublishCount)
+	{
+		Sensors_PublishCount = 0;
+		if(NULL_PTR != Sensors_Callback)
+		{
+			Sensors_Callback();
+		}
+	}
+}
+
+/**
+ * @brief get the filtered ADC value of a sensor, changes smaller than 
+ * SENSORS_DEADBAND are ignored
+ * 
+ * @param index sensor index
+ * @return uint16 filtered ADC value
+ */
+static uint16 Sensors_getFiltered(uint8 index)
+{
+	uint16 value;
+	uint16 diff;
+
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		value = Sensors_FilterSum[index];
+	}
+	value /= SENSORS_FILTER_LEN;
+
+	diff = (value > Sensors_Reported[index]) ? (value - Sensors_Reported[index]) : (Sensors_Reported[index] - value);
+	if(diff >= SENSORS_DEADBAND)
+	{
+		Sensors_Reported[index] = value;
+	}
+
+	return Sensors_Reported[index];
+}
+
+void Sensors_init(ADC_ScanCallback_t callback)
+{
+	Calibration_init();
+
+	Sensors_Callback = callback;
+	ADC_setScan(Sensors_Channels, SENSORS_COUNT, Sensors_ScanCallback);
+}
+
+void Sensors_startScan(void)
+{
+	ADC_startContinuousScan();
+}
+
 ERROR_t TEMP_u16_Read(uint16 * pTemp)
 {
 	uint16 adc_read;
 
-	adc_read = ADC_readChannel(TEMP_SENSOR_CH);
+	adc_read = Calibration_apply(TEMP_SENSOR_IDX, Sensors_getFiltered(TEMP_SENSOR_IDX));
 
-	/* convert adc value to temperature */
-	*pTemp = (uint16)(adc_read * 48.80) / 100;
+	/* convert 12 bit adc value to temperature */
+	*pTemp = Sensors_convert(adc_read, SENSORS_Q_FACTOR(TEMP_SCALE_X100));
 
 	return E_OK;
 }
@@ -29,9 +133,9 @@ ERROR_t Humi_u16_Read(uint16 * pHumi)
 	uint16 adc_read;
 
 	/* convert adc value to humidity value */
-	adc_read = ADC_readChannel(HUMI_SENSOR_CH);
+	adc_read = Calibration_apply(HUMI_SENSOR_IDX, Sensors_getFiltered(HUMI_SENSOR_IDX));
 	
-	*pHumi = (uint16)(adc_read * 48.80) / 100;
+	*pHumi = Sensors_convert(adc_read, SENSORS_Q_FACTOR(HUMI_SCALE_X100));
 
 	return E_OK;
 }
@@ -9,8 +9,35 @@
  * 
  */
 
+#include <avr/interrupt.h>
+#include <util/atomic.h>
 #include "adc.h"
 
+/* scan configuration */
+static uint8 ScanChannels[ADC_MAX_SCAN_CHANNELS];
+static uint8 ScanCount = 0;
+static ADC_ScanCallback_t ScanCallback = NULL_PTR;
+
+/* index of the channel being converted */
+static volatile uint8 ScanIndex = 0;
+
+/* oversampling accumulators and number of completed passes over the channels */
+static uint16 Sums[ADC_MAX_SCAN_CHANNELS];
+static uint8 Passes = 0;
+
+/* timer0 compare value for the continuous scan trigger */
+#define ADC_TRIGGER_OCR ((F_CPU / 1024UL / ADC_TRIGGER_HZ) - 1)
+
+#if (ADC_TRIGGER_OCR > 255) || (ADC_TRIGGER_OCR < 1)
+	#error ADC_TRIGGER_HZ is out of the timer0 range
+#endif
+
+/* double buffered samples, the ISR fills one buffer while the other 
+ * holds the last completed scan */
+static uint16 Samples[2][ADC_MAX_SCAN_CHANNELS];
+static volatile uint8 WriteBuffer = 0;
+static volatile uint8 ReadBuffer = 1;
+
 void ADC_init(void)
 {
 	/* ADMUX Register Bits Description:
@@ -22,7 +49,7 @@ void ADC_init(void)
 
 	/* ADCSRA Register Bits Description:
 	 * ADEN    = 1 Enable ADC
-	 * ADIE    = 0 Disable ADC Interrupt
+	 * ADIE    = 0 Disable ADC Interrupt, enabled only while scanning
 	 * ADPS2:0 = 110 to choose ADC_Clock= F_CPU/8 = 8Mhz/64= 125Khz --> ADC must operate in range 50-200Khz
 	 */
 	ADCSRA = (1<<ADEN) | (1<<ADPS2) | (1<<ADPS1);
@@ -50,3 +77,153 @@ uint16 ADC_readChannel(uint8 channel_num)
 	/* return the data register */
 	return ADC; 
 }
+
+void ADC_setScan(const uint8 * pChannels, uint8 count, ADC_ScanCallback_t callback)
+{
+	uint8 i;
+
+	if(count > ADC_MAX_SCAN_CHANNELS)
+	{
+		count = ADC_MAX_SCAN_CHANNELS;
+	}
+	for(i = 0; i < count; i++)
+	{
+		/* channel number must be from (0 --> 7) */
+		ScanChannels[i] = pChannels[i] & 0x07;
+	}
+	ScanCount = count;
+	ScanCallback = callback;
+}
+
+/**
+ * @brief reset the scan state and select the first scan channel
+ * 
+ * @return uint8 0 if a scan is already running or there is nothing to convert
+ */
+static uint8 ADC_prepareScan(void)
+{
+	uint8 i;
+
+	if(BIT_IS_SET(ADCSRA,ADIE) || (0 == ScanCount))
+	{
+		return 0;
+	}
+
+	ScanIndex = 0;
+	Passes = 0;
+	for(i = 0; i < ScanCount; i++)
+	{
+		Sums[i] = 0;
+	}
+	/* choose the first scan channel in MUX4:0 bits */
+	ADMUX = (ADMUX & 0xE0) | ScanChannels[0];
+
+	return 1;
+}
+
+void ADC_startScan(void)
+{
+	if(ADC_prepareScan())
+	{
+		/* clear any old ADIF by write '1' to it, enable the interrupt and start conversion */
+		ADCSRA |= (1<<ADIF) | (1<<ADIE) | (1<<ADSC);
+	}
+}
+
+void ADC_startContinuousScan(void)
+{
+	if(ADC_prepareScan())
+	{
+		/* timer0 CTC mode with F_CPU/1024 clock, no interrupt, the compare
+		 * match flag OCF0 is only used as the ADC trigger source */
+		OCR0 = ADC_TRIGGER_OCR;
+		TCNT0 = 0;
+		TCCR0 = (1<<WGM01) | (1<<CS02) | (1<<CS00);
+		TIFR = (1<<OCF0);
+
+		/* ADTS2:0 = 011 auto trigger on timer0 compare match */
+		SFIOR = (SFIOR & 0x1F) | (1<<ADTS1) | (1<<ADTS0);
+		ADCSRA |= (1<<ADIF) | (1<<ADIE) | (1<<ADATE);
+	}
+}
+
+void ADC_stopScan(void)
+{
+	ADCSRA &= ~((1<<ADIE) | (1<<ADATE));
+	/* stop timer0 */
+	TCCR0 = 0;
+}
+
+uint16 ADC_getSample(uint8 index)
+{
+	uint16 sample;
+
+	/* the 16 bit read must not be split by the buffer swap in the ISR */
+	ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+	{
+		sample = Samples[ReadBuffer][index];
+	}
+
+	return sample;
+}
+
+/**
+ * @brief conversion complete ISR, accumulate the sample and convert the next scan channel
+ * 
+ */
+ISR(ADC_vect)
+{
+	uint8 i;
+	uint8 published = 0;
+
+	Sums[ScanIndex] += ADC;
+	ScanIndex++;
+
+	if(ScanIndex == ScanCount)
+	{
+		ScanIndex = 0;
+		Passes++;
+
+		if(ADC_OVERSAMPLE_COUNT == Passes)
+		{
+			/* decimate the oversampled sums and publish the filled buffer */
+			Passes = 0;
+			for(i = 0; i < ScanCount; i++)
+			{
+				Samples[WriteBuffer][i] = Sums[i] >> ADC_OVERSAMPLE_BITS;
+				Sums[i] = 0;
+			}
+			ReadBuffer = WriteBuffer;
+			WriteBuffer ^= 1;
+
+			/* single scan is done */
+			if(BIT_IS_CLEAR(ADCSRA,ADATE))
+			{
+				CLEAR_BIT(ADCSRA,ADIE);
+			}
+
+			published = 1;
+		}
+	}
+
+	/* the ADC already sampled the previous channel so MUX can change now */
+	ADMUX = (ADMUX & 0xE0) | ScanChannels[ScanIndex];
+
+	if(BIT_IS_SET(ADCSRA,ADATE))
+	{
+		/* clear OCF0 so that the next timer0 compare match triggers the next conversion */
+		TIFR = (1<<OCF0);
+	}
+	else if(BIT_IS_SET(ADCSRA,ADIE))
+	{
+		/* single scan, start the next conversion now */
+		SET_BIT(ADCSRA,ADSC);
+	}
+
+	/* the callback may switch to a woken task, so it comes last when the
+	 * next conversion is already set up */
+	if(published && (NULL_PTR != ScanCallback))
+	{
+		ScanCallback();
+	}
+}
@@ -9,21 +9,52 @@
  * 
  */
 
+#include <avr/interrupt.h>
 #include "uart.h"
+#include "task.h"
+#include "semphr.h"
+
+#define UART_RX_MASK	(UART_RX_BUFFER_SIZE - 1)
+#define UART_TX_MASK	(UART_TX_BUFFER_SIZE - 1)
+
+#if (UART_RX_BUFFER_SIZE & UART_RX_MASK) || (UART_TX_BUFFER_SIZE & UART_TX_MASK)
+	#error UART buffer sizes must be a power of 2
+#endif
+
+/* RX ring buffer, head is moved by the RX ISR and tail by the reader task */
+static uint8 RxBuffer[UART_RX_BUFFER_SIZE];
+static volatile uint8 RxHead = 0;
+static volatile uint8 RxTail = 0;
+
+/* TX ring buffer, head is moved by the writer tasks and tail by the UDRE ISR */
+static uint8 TxBuffer[UART_TX_BUFFER_SIZE];
+static volatile uint8 TxHead = 0;
+static volatile uint8 TxTail = 0;
+
+/* given by the RX ISR to wake up the task sleeping in UART_read() */
+static SemaphoreHandle_t bsRxReady = NULL;
+static StaticSemaphore_t RxReadyBuffer;
+
+/* given by the UDRE ISR to wake up the tasks sleeping in UART_sendByte() on a
+ * full TX buffer, only while TxWaiting counts such tasks */
+static SemaphoreHandle_t bsTxSpace = NULL;
+static StaticSemaphore_t TxSpaceBuffer;
+static volatile uint8 TxWaiting = 0;
 
 void UART_init(void)
 {
 	UCSRA = (1<<U2X); /* U2X = 1 for double transmission speed */
 	/************************** UCSRB Description **************************
-	 * RXCIE = 0 Disable USART RX Complete Interrupt Enable
+	 * RXCIE = 1 Enable USART RX Complete Interrupt Enable
 	 * TXCIE = 0 Disable USART TX Complete Interrupt Enable
-	 * UDRIE = 0 Disable USART Data Register Empty Interrupt Enable
+	 * UDRIE = 0 USART Data Register Empty Interrupt is enabled only while
+	 *           the TX buffer has data
 	 * RXEN  = 1 Receiver Enable
 	 * RXEN  = 1 Transmitter Enable
 	 * UCSZ2 = 0 For 8-bit data mode
 	 * RXB8 & TXB8 not used for 8-bit data mode
 	 ***********************************************************************/ 
-	UCSRB = (1<<RXEN) | (1<<TXEN);
+	UCSRB = (1<<RXCIE) | (1<<RXEN) | (1<<TXEN);
 	
 	/************************** UCSRC Description **************************
 	 * URSEL   = 1 The URSEL must be one when writing the UCSRC
@@ -38,41 +69,147 @@ void UART_init(void)
 	/* baud rate=9600 & Fosc= 8 MHz -->  UBBR=( Fosc / (8 * baud rate) ) - 1 = 12 */  
 	UBRRH = 0;
 	UBRRL = 103;
+
+	bsRxReady = xSemaphoreCreateBinaryStatic(&RxReadyBuffer);
+	bsTxSpace = xSemaphoreCreateBinaryStatic(&TxSpaceBuffer);
+}
+
+uint8 UART_write(const uint8 * pBuf, uint8 len)
+{
+	uint8 count = 0;
+	uint8 next;
+
+	taskENTER_CRITICAL();
+	while(count < len)
+	{
+		next = (TxHead + 1) & UART_TX_MASK;
+		/* TX buffer is full */
+		if(next == TxTail)
+		{
+			break;
+		}
+		TxBuffer[TxHead] = pBuf[count];
+		TxHead = next;
+		count++;
+	}
+	/* the UDRE ISR disables itself when the TX buffer becomes empty */
+	if(count > 0)
+	{
+		SET_BIT(UCSRB,UDRIE);
+	}
+	taskEXIT_CRITICAL();
+
+	return count;
+}
+
+ERROR_t UART_writeFrame(const uint8 * pBuf, uint8 len)
+{
+	ERROR_t result = E_NOK;
+
+	taskENTER_CRITICAL();
+	/* one entry is always free to tell a full buffer from an empty one */
+	if(((UART_TX_BUFFER_SIZE - 1) - ((TxHead - TxTail) & UART_TX_MASK)) >= len)
+	{
+		(void)UART_write(pBuf, len);
+		result = E_OK;
+	}
+	taskEXIT_CRITICAL();
+
+	return result;
+}
+
+uint8 UART_read(uint8 * pBuf, uint8 len, TickType_t xTimeout)
+{
+	uint8 count = 0;
+
+	while(count < len)
+	{
+		if(E_OK == UART_receiveByte_NonBlocking(&pBuf[count]))
+		{
+			count++;
+		}
+		/* buffer is empty so sleep until the RX ISR receives a new byte */
+		else if(pdFALSE == xSemaphoreTake(bsRxReady, xTimeout))
+		{
+			break;
+		}
+	}
+
+	return count;
 }
 	
 void UART_sendByte(const uint8 data)
 {
-	/* UDRE flag is set when the TX buffer (UDR) is empty and ready for 
-	 * transmitting a new byte so wait until this flag is set to one */
-	while(BIT_IS_CLEAR(UCSRA,UDRE)){}
-	/* Put the required data in the UDR register and it also clear the UDRE flag as 
-	 * the UDR register is not empty now */	 
-	UDR = data;
-	/************** Another Method *********************
-	UDR = data;
-	// Wait until the transmission is complete TXC = 1 
-	while(BIT_IS_CLEAR(UCSRA,TXC)){}
-	// Clear the TXC flag
-	SET_BIT(UCSRA,TXC); 
-	****************************************************/	
+	uint8 full;
+
+	/* wait only if the TX buffer is full */
+	while(0 == UART_write(&data, 1))
+	{
+		/* interrupts are disabled (e.g. before the scheduler starts) so the UDRE
+		 * ISR can not drain the buffer, send the oldest byte by polling */
+		if(BIT_IS_CLEAR(SREG,SREG_I))
+		{
+			while(BIT_IS_CLEAR(UCSRA,UDRE)){}
+			UDR = TxBuffer[TxTail];
+			TxTail = (TxTail + 1) & UART_TX_MASK;
+		}
+		else
+		{
+			/* sleep until the UDRE ISR sends a byte, the buffer is checked again
+			 * with the interrupts disabled so that byte can not be missed */
+			taskENTER_CRITICAL();
+			full = (((TxHead + 1) & UART_TX_MASK) == TxTail);
+			if(full)
+			{
+				TxWaiting++;
+			}
+			taskEXIT_CRITICAL();
+
+			if(full)
+			{
+				(void)xSemaphoreTake(bsTxSpace, portMAX_DELAY);
+				taskENTER_CRITICAL();
+				TxWaiting--;
+				taskEXIT_CRITICAL();
+			}
+		}
+	}
+}
+
+void UART_flushPolled(void)
+{
+	/* with the interrupts enabled the UDRE ISR owns the tail */
+	if(BIT_IS_SET(SREG,SREG_I))
+	{
+		return;
+	}
+
+	while(TxHead != TxTail)
+	{
+		while(BIT_IS_CLEAR(UCSRA,UDRE)){}
+		UDR = TxBuffer[TxTail];
+		TxTail = (TxTail + 1) & UART_TX_MASK;
+	}
+	CLEAR_BIT(UCSRB,UDRIE);
 }
 
 uint8 UART_receiveByte(void)
 {
-	/* RXC flag is set when the UART receive data so wait until this 
-	 * flag is set to one */
-	while(BIT_IS_CLEAR(UCSRA,RXC)){}
-	/* Read the received data from the Rx buffer (UDR) and the RXC flag 
-	   will be cleared after read this data */	 
-    return UDR;		
+	uint8 data;
+
+	/* sleep until a byte is received */
+	while(0 == UART_read(&data, 1, portMAX_DELAY)){}
+
+	return data;
 }
 
 ERROR_t UART_receiveByte_NonBlocking(uint8 * pData)
 {
-	/* Wait for data to be received */
-	if ( (UCSRA & (1<<RXC)) )
+	/* check if there is data in the RX buffer */
+	if(RxHead != RxTail)
 	{
-		*pData = UDR;
+		*pData = RxBuffer[RxTail];
+		RxTail = (RxTail + 1) & UART_RX_MASK;
 		return E_OK;
 	}
 	else
@@ -112,3 +249,60 @@ void UART_receiveString(char *Str)
 	/* add null at the end of string */
 	Str[i] = '\0';
 }
+
+/**
+ * @brief RX complete ISR, store the received byte and wake up the reader task
+ * 
+ */
+ISR(USART_RXC_vect)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+	/* read UDR in all cases to clear the RXC flag */
+	uint8 data = UDR;
+	uint8 next = (RxHead + 1) & UART_RX_MASK;
+
+	/* drop the byte if the RX buffer is full */
+	if(next != RxTail)
+	{
+		RxBuffer[RxHead] = data;
+		RxHead = next;
+	}
+
+	xSemaphoreGiveFromISR(bsRxReady, &xHigherPriorityTaskWoken);
+	if(pdFALSE != xHigherPriorityTaskWoken)
+	{
+		taskYIELD();
+	}
+}
+
+/**
+ * @brief data register empty ISR, send the next byte from the TX buffer and
+ * wake up a task waiting for room
+ * 
+ */
+ISR(USART_UDRE_vect)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	if(TxHead != TxTail)
+	{
+		UDR = TxBuffer[TxTail];
+		TxTail = (TxTail + 1) & UART_TX_MASK;
+
+		/* an entry is free, wake up a task waiting for one */
+		if(TxWaiting)
+		{
+			xSemaphoreGiveFromISR(bsTxSpace, &xHigherPriorityTaskWoken);
+		}
+	}
+	else
+	{
+		/* nothing to send, disable the interrupt until new data is queued */
+		CLEAR_BIT(UCSRB,UDRIE);
+	}
+
+	if(pdFALSE != xHigherPriorityTaskWoken)
+	{
+		taskYIELD();
+	}
+}
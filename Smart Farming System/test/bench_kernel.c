@@ -0,0 +1,154 @@
+/**
+ * @file bench_kernel.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host benchmark of the kernel signalling paths over the simulated
+ * kernel, not run by ctest
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * use: bench_kernel [iterations]
+ *
+ * each case runs from one task, so nothing blocks and only the cost of the
+ * calls is timed, in host nanoseconds per iteration: the numbers compare the
+ * code paths of the same kernel but are not ATmega32 cycles (the host port
+ * critical sections are function calls, not cli / sei)
+ *
+ * the snapshot cases read a data group of the size of the sensor data with
+ * Snapshot_read() and with the same byte copy inside a critical section
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "event_groups.h"
+#include "snapshot.h"
+#include "datamodel.h"
+
+#define BENCH_DEFAULT_ITERATIONS	1000000UL
+#define BENCH_STACK					200
+
+static StackType_t Bench_Stack[BENCH_STACK];
+static StaticTask_t Bench_TCB;
+static TaskHandle_t Bench_Task;
+
+static SemaphoreHandle_t Bench_Semaphore;
+static StaticSemaphore_t Bench_SemaphoreBuffer;
+static EventGroupHandle_t Bench_EventGroup;
+static StaticEventGroup_t Bench_EventGroupBuffer;
+
+static Snapshot_t Bench_Snapshot;
+static SensorData_t Bench_Data;
+static SensorData_t Bench_Copy;
+
+static unsigned long Bench_Iterations = BENCH_DEFAULT_ITERATIONS;
+
+/**
+ * @brief host time in nanoseconds
+ *
+ */
+static unsigned long long Bench_now(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((unsigned long long)now.tv_sec * 1000000000ULL) + (unsigned long long)now.tv_nsec;
+}
+
+/**
+ * @brief time a case and print the cost of one iteration
+ *
+ */
+static void Bench_run(const char * pName, void (*pCase)(void))
+{
+	unsigned long long start;
+	unsigned long k;
+
+	/* warm up */
+	for(k = 0; k < 1000; k++)
+	{
+		pCase();
+	}
+
+	start = Bench_now();
+	for(k = 0; k < Bench_Iterations; k++)
+	{
+		pCase();
+	}
+
+	printf("%-40s %8.1f ns\n", pName, (double)(Bench_now() - start) / (double)Bench_Iterations);
+}
+
+/* signal and take it back, the three ways a task is woken up */
+static void Bench_notify(void)
+{
+	(void)xTaskNotifyGive(Bench_Task);
+	(void)ulTaskNotifyTake(pdTRUE, 0);
+}
+
+static void Bench_semaphore(void)
+{
+	(void)xSemaphoreGive(Bench_Semaphore);
+	(void)xSemaphoreTake(Bench_Semaphore, 0);
+}
+
+static void Bench_eventGroup(void)
+{
+	(void)xEventGroupSetBits(Bench_EventGroup, 1);
+	(void)xEventGroupWaitBits(Bench_EventGroup, 1, pdTRUE, pdFALSE, 0);
+}
+
+/* a consistent copy of a data group, the two ways a reader gets one */
+static void Bench_snapshotRead(void)
+{
+	SNAPSHOT_READ(Bench_Snapshot, Bench_Data, Bench_Copy);
+}
+
+static void Bench_criticalRead(void)
+{
+	const volatile uint8 * pSrc = (const volatile uint8 *)&Bench_Data;
+	volatile uint8 * pDst = (volatile uint8 *)&Bench_Copy;
+	uint8 count;
+
+	taskENTER_CRITICAL();
+	for(count = sizeof(Bench_Data); count > 0; count--)
+	{
+		*pDst++ = *pSrc++;
+	}
+	taskEXIT_CRITICAL();
+}
+
+static void Bench_main(void * pvParam)
+{
+	(void)pvParam;
+
+	printf("%lu iterations, host ns per iteration\n", Bench_Iterations);
+
+	Bench_run("notify give + take", Bench_notify);
+	Bench_run("binary semaphore give + take", Bench_semaphore);
+	Bench_run("event group set + wait", Bench_eventGroup);
+	Bench_run("snapshot read", Bench_snapshotRead);
+	Bench_run("critical section read", Bench_criticalRead);
+
+	exit(EXIT_SUCCESS);
+}
+
+int main(int argc, char ** argv)
+{
+	if((argc > 1) && (atol(argv[1]) > 0))
+	{
+		Bench_Iterations = (unsigned long)atol(argv[1]);
+	}
+
+	Bench_Semaphore = xSemaphoreCreateBinaryStatic(&Bench_SemaphoreBuffer);
+	Bench_EventGroup = xEventGroupCreateStatic(&Bench_EventGroupBuffer);
+	Bench_Task = xTaskCreateStatic(Bench_main, "BENCH", BENCH_STACK, NULL, 1, Bench_Stack, &Bench_TCB);
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
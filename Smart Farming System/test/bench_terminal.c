@@ -0,0 +1,326 @@
+/**
+ * @file bench_terminal.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host benchmark of the terminal input over the simulated kernel, the
+ * task that polled the uart every 50 ms against the task that sleeps until
+ * the RX interrupt, not run by ctest
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * use: bench_terminal [keys]
+ *
+ * a host thread types 'C' at random times, 100 to 300 ms apart, through the
+ * RX interrupt of the uart driver (src/MCAL/uart.c). The terminal task at
+ * priority 4 switches a text on the lcd frame buffer for each 'C', like the
+ * config screen, and the idle hook sends it with the lcd driver to the
+ * HD44780 model (sim/src/ECU/lcd_model.c) as the application does. The
+ * display task between them is left out, it adds the same time to both.
+ * The same keys are typed at the old polling task first, then at the
+ * blocking one
+ *
+ * printed for each task:
+ * - the keystroke to lcd latency, from the RX interrupt to the end of the lcd
+ *   write: the simulated time to the flush and the bus time of the write
+ * - the wake ups of the terminal task per second
+ * - the idle share, the run time of the idle task against the total
+ *
+ * the run time is simulated time, the host time of the code multiplied by
+ * SFS_SIM_SPEED, so the idle share is the one of the host threads and not of
+ * the ATmega32, the wake ups are the same on both
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <avr/interrupt.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "uart.h"
+#include "lcd.h"
+#include "lcd_model.h"
+
+/* src/ECU/lcd.c is built with its flush renamed for the simulation screen
+ * (CMakeLists.txt), the benchmark calls the driver one */
+void LCD_driverFlush(void);
+
+#define BENCH_DEFAULT_KEYS		40
+#define BENCH_STACK				200
+
+/* run time counts of the target timer 1 and of the host port */
+#define BENCH_US_PER_COUNT		8.0
+
+/* the period of the old terminal loop */
+#define BENCH_POLL_TICKS		50
+
+/* simulated time between two keys */
+#define BENCH_GAP_MIN_US		100000UL
+#define BENCH_GAP_MAX_US		300000UL
+
+/* typed after the keys of a task, the task then stops */
+#define BENCH_END				'X'
+
+typedef enum
+{
+	BENCH_POLLING,
+	BENCH_BLOCKING,
+	BENCH_WAYS
+} Bench_Way_t;
+
+typedef struct
+{
+	const char * Name;
+	unsigned long Keys;
+	double LatencyMin;
+	double LatencyMax;
+	double LatencySum;
+	unsigned long Wakes;
+	uint32 StartTotal;
+	uint32 StartIdle;
+	uint32 Total;
+	uint32 Idle;
+} Bench_Result_t;
+
+static StackType_t Bench_IdleStack[configMINIMAL_STACK_SIZE];
+static StaticTask_t Bench_IdleTCB;
+static StackType_t Bench_TerminalStack[BENCH_STACK];
+static StaticTask_t Bench_TerminalTCB;
+
+static Bench_Result_t Bench_Results[BENCH_WAYS] =
+{
+	{ .Name = "polling every 50 ms" },
+	{ .Name = "blocking on the RX interrupt" }
+};
+
+static unsigned long Bench_Keys = BENCH_DEFAULT_KEYS;
+
+/* task under test, set by the terminal task */
+static volatile Bench_Way_t Bench_Way = BENCH_POLLING;
+
+/* byte of the next RX interrupt and the time it was taken */
+static volatile uint8 Bench_RxByte;
+static volatile uint64_t Bench_KeyUs;
+
+/* set by the idle hook when the lcd shows the key */
+static volatile uint8 Bench_Shown = 0;
+
+/**
+ * @brief the RX complete vector, the "USART" received the byte
+ *
+ */
+static void Bench_rxIsr(void)
+{
+	UDR = Bench_RxByte;
+	Bench_KeyUs = ullPortSimTimeUs();
+	USART_RXC_vect();
+}
+
+/**
+ * @brief type a key, the interrupt is taken when the running code enables
+ * interrupts
+ *
+ */
+static void Bench_type(uint8 key)
+{
+	Bench_Shown = 0;
+	Bench_RxByte = key;
+	vPortSimRaiseIsr(USART_RXC_vect_num);
+}
+
+/**
+ * @brief the keyboard, a host thread in simulated time
+ *
+ */
+static void * Bench_keyboard(void * pvArg)
+{
+	Bench_Way_t way;
+	unsigned long k;
+
+	(void)pvArg;
+
+	for(way = BENCH_POLLING; way < BENCH_WAYS; way++)
+	{
+		for(k = 0; k < Bench_Keys; k++)
+		{
+			vPortSimSleepUs(BENCH_GAP_MIN_US + (uint32)(rand() % (BENCH_GAP_MAX_US - BENCH_GAP_MIN_US)));
+			Bench_type('C');
+			while(!Bench_Shown)
+			{
+				vPortSimSleepUs(100);
+			}
+		}
+
+		vPortSimSleepUs(BENCH_GAP_MIN_US);
+		Bench_type(BENCH_END);
+	}
+
+	return NULL;
+}
+
+/**
+ * @brief the old terminal loop, a look at the RX buffer every 50 ms
+ *
+ */
+static uint8 Bench_pollByte(void)
+{
+	uint8 data;
+
+	while(E_OK != UART_receiveByte_NonBlocking(&data))
+	{
+		vTaskDelay(BENCH_POLL_TICKS);
+		Bench_Results[BENCH_POLLING].Wakes++;
+	}
+
+	return data;
+}
+
+/**
+ * @brief the terminal task now, it sleeps until the RX ISR receives a byte
+ *
+ */
+static uint8 Bench_blockByte(void)
+{
+	uint8 data = UART_receiveByte();
+
+	Bench_Results[BENCH_BLOCKING].Wakes++;
+
+	return data;
+}
+
+static void Bench_print(const Bench_Result_t * pResult)
+{
+	double seconds = (double)pResult->Total * BENCH_US_PER_COUNT / 1000000.0;
+
+	printf("%s:\n", pResult->Name);
+	printf("  keystroke to lcd  min %7.3f ms  mean %7.3f ms  max %7.3f ms  (%lu keys)\n",
+		pResult->LatencyMin / 1000.0, pResult->LatencySum / 1000.0 / (double)pResult->Keys,
+		pResult->LatencyMax / 1000.0, pResult->Keys);
+	printf("  terminal wake ups %7.2f per second (%lu in %.1f s)\n",
+		(double)pResult->Wakes / seconds, pResult->Wakes, seconds);
+	printf("  idle share        %7.3f %%\n", 100.0 * (double)pResult->Idle / (double)pResult->Total);
+}
+
+static void Bench_terminal(void * pvParam)
+{
+	Bench_Result_t * pResult;
+	uint8 shown = 0;
+	uint8 data;
+
+	(void)pvParam;
+
+	for(Bench_Way = BENCH_POLLING; Bench_Way < BENCH_WAYS; Bench_Way++)
+	{
+		pResult = &Bench_Results[Bench_Way];
+		pResult->StartTotal = portGET_RUN_TIME_COUNTER_VALUE();
+		pResult->StartIdle = ulTaskGetRunTimeCounter((TaskHandle_t)&Bench_IdleTCB);
+
+		do
+		{
+			data = (BENCH_POLLING == Bench_Way) ? Bench_pollByte() : Bench_blockByte();
+
+			/* the config screen in and out */
+			if('C' == data)
+			{
+				shown = !shown;
+				LCD_displayStringRowColumn(0, 0, shown ? "CONFIG  " : "MAIN    ");
+			}
+		} while(BENCH_END != data);
+
+		pResult->Total = portGET_RUN_TIME_COUNTER_VALUE() - pResult->StartTotal;
+		pResult->Idle = ulTaskGetRunTimeCounter((TaskHandle_t)&Bench_IdleTCB) - pResult->StartIdle;
+	}
+
+	Bench_print(&Bench_Results[BENCH_POLLING]);
+	Bench_print(&Bench_Results[BENCH_BLOCKING]);
+
+	exit(EXIT_SUCCESS);
+}
+
+/**
+ * @brief sends the lcd changes like the application idle hook, the latency of
+ * the key ends with the write
+ *
+ */
+void vApplicationIdleHook(void)
+{
+	Bench_Result_t * pResult;
+	uint64_t busNs = LCD_Model.TimeNs;
+	double latency;
+
+	/* the simulated kernel takes the interrupts only when the running code
+	 * enables them, and with one tick left before the next wake up the idle
+	 * task makes no kernel call while it waits for the tick */
+	portENABLE_INTERRUPTS();
+
+	LCD_driverFlush();
+
+	if(LCD_Model.ScreenChanged)
+	{
+		LCD_Model.ScreenChanged = 0;
+
+		pResult = &Bench_Results[Bench_Way];
+		latency = (double)(ullPortSimTimeUs() - Bench_KeyUs) + ((double)(LCD_Model.TimeNs - busNs) / 1000.0);
+		if((0 == pResult->Keys) || (latency < pResult->LatencyMin))
+		{
+			pResult->LatencyMin = latency;
+		}
+		if(latency > pResult->LatencyMax)
+		{
+			pResult->LatencyMax = latency;
+		}
+		pResult->LatencySum += latency;
+		pResult->Keys++;
+
+		Bench_Shown = 1;
+	}
+}
+
+unsigned char ucApplicationIdleHookBusy(void)
+{
+	return 0;
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char * pcTaskName)
+{
+	(void)xTask;
+
+	printf("stack overflow of %s\n", pcTaskName);
+	exit(EXIT_FAILURE);
+}
+
+void vApplicationGetIdleTaskMemory(StaticTask_t ** ppxIdleTaskTCBBuffer, StackType_t ** ppxIdleTaskStackBuffer, uint16_t * pusIdleTaskStackSize)
+{
+	*ppxIdleTaskTCBBuffer = &Bench_IdleTCB;
+	*ppxIdleTaskStackBuffer = Bench_IdleStack;
+	*pusIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
+
+int main(int argc, char ** argv)
+{
+	pthread_t thread;
+
+	if((argc > 1) && (atol(argv[1]) > 0))
+	{
+		Bench_Keys = (unsigned long)atol(argv[1]);
+	}
+
+	/* the same keys at the same times each run */
+	srand(1);
+
+	UART_init();
+	LCD_init();
+	LCD_Model.ScreenChanged = 0;
+
+	vPortSimInstallIsr(USART_RXC_vect_num, Bench_rxIsr);
+	if(0 != pthread_create(&thread, NULL, Bench_keyboard, NULL))
+	{
+		return EXIT_FAILURE;
+	}
+
+	xTaskCreateStatic(Bench_terminal, "TERM", BENCH_STACK, NULL, 4, Bench_TerminalStack, &Bench_TerminalTCB);
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
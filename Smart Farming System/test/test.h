@@ -0,0 +1,37 @@
+/**
+ * @file test.h
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief checks of the host tests
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * a test is a host program run by ctest, it prints each failed check and
+ * returns Test_result(), non zero when a check failed
+ *
+ */
+
+#ifndef TEST_H_
+#define TEST_H_
+
+#include <stdio.h>
+
+/* failed checks of the test program */
+static unsigned Test_Failures = 0;
+
+#define TEST_CHECK(COND)	do { if(!(COND)) { Test_Failures++; \
+								printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #COND); } } while(0)
+
+/* the values are printed when they differ */
+#define TEST_EQUAL(ACTUAL, EXPECTED)	do { long long a_ = (long long)(ACTUAL), e_ = (long long)(EXPECTED); \
+								if(a_ != e_) { Test_Failures++; \
+								printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #ACTUAL, a_, e_); } } while(0)
+
+static inline int Test_result(const char * pName)
+{
+	printf("%s: %s (%u failed checks)\n", pName, Test_Failures ? "FAILED" : "passed", Test_Failures);
+	return Test_Failures ? 1 : 0;
+}
+
+#endif /* TEST_H_ */
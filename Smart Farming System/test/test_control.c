@@ -0,0 +1,268 @@
+/**
+ * @file test_control.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host test of the actuator control engine (src/APP/control.c)
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * checked:
+ * - the heater interlock turns the heater off at once and, after the release,
+ *   keeps it off for its min off time in on/off and in PID mode
+ * - after an hour of saturation in PID mode, with a noisy reading that the
+ *   derivative term turns into short unsaturated windows, the integral is held
+ *   to a whole window of output and the relay is off again within the windows
+ *   that takes to unwind, the recovery time is printed
+ * - a replayed temperature trace (a slow swing around the threshold with +-1
+ *   noise, one reading every 500 ms for an hour) switches the relays fewer
+ *   times than the strict comparisons of the old T_SysCheck, and signals
+ *   T_Control and the motors screen of T_Display fewer times: the old task
+ *   set and cleared the cooler / heater bits of egControl and set
+ *   E_MotorState of egDisplay for every reading, now the data model signals
+ *   both tasks once for each update that changed an actuator, the counts of
+ *   both are printed
+ *
+ */
+
+#include "test.h"
+#include "control.h"
+
+/* readings of the replayed trace, every 500 ms for one hour */
+#define TEST_READING_TICKS	500
+#define TEST_READINGS		7200
+#define TEST_THRESHOLD		25
+
+/**
+ * @brief the heater interlock of T_SysCheck
+ *
+ */
+static uint8 Test_heater(uint8 cooler, sint16 error, TickType_t now, TickType_t * pWait)
+{
+	Control_interlock(CONTROL_HEATER, cooler);
+	return Control_update(CONTROL_HEATER, error, now, pWait);
+}
+
+static void Test_interlockOnOff(void)
+{
+	TickType_t wait;
+	TickType_t t = 1000;
+
+	Control_init();
+
+	/* cold, the heater turns on (the first change is not held back) */
+	wait = portMAX_DELAY;
+	TEST_EQUAL(Test_heater(0, 5, t, &wait), 1);
+
+	/* the cooler comes on before the min on time, the heater goes off now */
+	t += 1000;
+	wait = portMAX_DELAY;
+	TEST_EQUAL(Test_heater(1, 5, t, &wait), 0);
+	TEST_EQUAL(wait, portMAX_DELAY);
+
+	/* released while still cold, off until the min off time passed */
+	t += 1000;
+	wait = portMAX_DELAY;
+	TEST_EQUAL(Test_heater(0, 5, t, &wait), 0);
+	TEST_EQUAL(wait, CONTROL_HEATER_MIN_OFF - 1000);
+
+	wait = portMAX_DELAY;
+	TEST_EQUAL(Test_heater(0, 5, t + CONTROL_HEATER_MIN_OFF - 1001, &wait), 0);
+	TEST_EQUAL(wait, 1);
+
+	wait = portMAX_DELAY;
+	TEST_EQUAL(Test_heater(0, 5, t + CONTROL_HEATER_MIN_OFF - 1000, &wait), 1);
+}
+
+static void Test_interlockPid(void)
+{
+	const Control_Tuning_t tuning = {CONTROL_MODE_PID, CONTROL_TEMP_KP, CONTROL_TEMP_KI, CONTROL_TEMP_KD};
+	TickType_t wait;
+	TickType_t t;
+	TickType_t off = 0;
+	uint8 on = 0;
+
+	Control_init();
+	/* the PID windows are timed from the tick count of the tuning */
+	TEST_EQUAL(Control_setTuning(CONTROL_HEATER, &tuning), E_OK);
+
+	/* far below the threshold the whole window is on */
+	wait = portMAX_DELAY;
+	TEST_EQUAL(Test_heater(0, 20, 0, &wait), 1);
+	TEST_EQUAL(wait, CONTROL_SLOT_TICKS);
+
+	/* interlock in the middle of the window */
+	wait = portMAX_DELAY;
+	TEST_EQUAL(Test_heater(1, 20, 350, &wait), 0);
+
+	/* released, the slots run on but the relay waits for the min off time */
+	for(t = 400; t < (350 + CONTROL_HEATER_MIN_OFF + (2 * CONTROL_SLOT_TICKS)); t += CONTROL_SLOT_TICKS)
+	{
+		wait = portMAX_DELAY;
+		if(Test_heater(0, 20, t, &wait) && !on)
+		{
+			on = 1;
+			off = t;
+		}
+		TEST_CHECK(wait <= CONTROL_SLOT_TICKS);
+	}
+	TEST_CHECK(on);
+	TEST_CHECK(off >= (350 + CONTROL_HEATER_MIN_OFF));
+	TEST_CHECK(off < (350 + CONTROL_HEATER_MIN_OFF + CONTROL_SLOT_TICKS));
+}
+
+static void Test_windup(void)
+{
+	/* 1 slot per unit, 1 slot per unit per window and 200 slots per unit of
+	 * change, so a reading falling by 1 unsaturates the output for a window */
+	const Control_Tuning_t tuning = {CONTROL_MODE_PID, 1 << CONTROL_GAIN_BITS, 1 << CONTROL_GAIN_BITS, 200 << CONTROL_GAIN_BITS};
+	const sint16 recoveryError = -2;
+	/* the integral unwinds from a whole window by the error each window */
+	const unsigned maxWindows = (CONTROL_WINDOW_SLOTS / 2) + 2;
+	TickType_t wait;
+	TickType_t t = 0;
+	unsigned window;
+	unsigned slot;
+	unsigned onSlots;
+	unsigned windows = 0;
+
+	Control_init();
+	TEST_EQUAL(Control_setTuning(CONTROL_HEATER, &tuning), E_OK);
+
+	/* far too cold for an hour, the error goes 5, 4, 5, 4... */
+	for(window = 0; window < 360; window++)
+	{
+		for(slot = 0; slot < CONTROL_WINDOW_SLOTS; slot++)
+		{
+			wait = portMAX_DELAY;
+			(void)Test_heater(0, (window & 1) ? 4 : 5, t, &wait);
+			t += CONTROL_SLOT_TICKS;
+		}
+	}
+
+	/* just above the threshold, the last window with the relay on */
+	for(window = 1; window <= (40 * maxWindows); window++)
+	{
+		onSlots = 0;
+		for(slot = 0; slot < CONTROL_WINDOW_SLOTS; slot++)
+		{
+			wait = portMAX_DELAY;
+			onSlots += Test_heater(0, recoveryError, t, &wait);
+			t += CONTROL_SLOT_TICKS;
+		}
+		if(onSlots)
+		{
+			windows = window;
+		}
+	}
+
+	printf("heater off for good %u windows (%lu s) after an hour of saturation\n",
+		   windows, (unsigned long)((windows * CONTROL_WINDOW_SLOTS * CONTROL_SLOT_TICKS) / 1000));
+	TEST_CHECK(windows <= maxWindows);
+}
+
+/**
+ * @brief next value of a fixed pseudo random sequence
+ *
+ */
+static uint32 Test_random(uint32 * pSeed)
+{
+	*pSeed = (*pSeed * 1103515245UL) + 12345UL;
+	return (*pSeed >> 16) & 0x7FFF;
+}
+
+/**
+ * @brief the temperature of the replayed trace, a triangle of +-3 degrees
+ * with a 20 minutes period around the threshold and a +-1 noise
+ *
+ */
+static uint8 Test_reading(uint16 k, uint32 * pSeed)
+{
+	const uint16 period = 2400;
+	uint16 phase = k % period;
+	sint16 swing = (phase < (period / 2)) ? (sint16)phase : (sint16)(period - phase);
+	sint16 noise = (sint16)(Test_random(pSeed) % 3) - 1;
+
+	/* 0 to 1200 -> -3 to +3 */
+	return (uint8)(TEST_THRESHOLD - 3 + ((swing * 6) / 1200) + noise);
+}
+
+static void Test_replay(void)
+{
+	uint32 seed = 1;
+	uint16 k;
+	uint8 temp;
+	uint8 oldCooler = 0, oldHeater = 0;
+	uint8 cooler = 0, heater = 0;
+	uint8 state;
+	unsigned oldSwitches = 0;
+	unsigned switches = 0;
+	unsigned oldControlOps = 0;
+	unsigned oldScreenSignals = 0;
+	unsigned signals = 0;
+	uint8 changed;
+	TickType_t now = 0;
+	TickType_t next;
+	TickType_t wait = portMAX_DELAY;
+	uint32 elapsed = 0;
+
+	Control_init();
+
+	for(k = 0; k < TEST_READINGS; k++)
+	{
+		temp = Test_reading(k, &seed);
+
+		/* the old T_SysCheck: cooler above, heater below, both off when equal */
+		state = (temp > TEST_THRESHOLD);
+		oldSwitches += (state != oldCooler);
+		oldCooler = state;
+		state = (temp < TEST_THRESHOLD);
+		oldSwitches += (state != oldHeater);
+		oldHeater = state;
+		/* set and clear E_COOLER | E_HEATER, then set E_MotorState */
+		oldControlOps += 2;
+		oldScreenSignals++;
+
+		/* T_SysCheck wakes up on the reading and when a held change is due */
+		next = (TickType_t)(now + TEST_READING_TICKS);
+		do
+		{
+			wait = portMAX_DELAY;
+			state = Control_update(CONTROL_COOLER, (sint16)temp - TEST_THRESHOLD, now, &wait);
+			changed = (state != cooler);
+			cooler = state;
+			state = Test_heater(cooler, TEST_THRESHOLD - (sint16)temp, now, &wait);
+			TEST_CHECK(!(cooler && state));
+			changed += (state != heater);
+			heater = state;
+			switches += changed;
+			/* DataModel_setMotors() calls the subscribers only on a change */
+			signals += (changed != 0);
+
+			if(wait >= (TickType_t)(next - now))
+			{
+				break;
+			}
+			now += wait;
+		} while(1);
+		now = next;
+		elapsed += TEST_READING_TICKS;
+	}
+
+	printf("replayed %lu s: %u relay switches with the strict comparisons, %u with the bands and dwell times\n",
+		   (unsigned long)(elapsed / 1000), oldSwitches, switches);
+	printf("  T_Control signals: %u egControl operations before, %u notifications now\n", oldControlOps, signals);
+	printf("  motors screen signals: %u E_MotorState sets before, %u notifications now\n", oldScreenSignals, signals);
+	TEST_CHECK(switches < oldSwitches);
+	TEST_CHECK(signals < oldScreenSignals);
+}
+
+int main(void)
+{
+	Test_interlockOnOff();
+	Test_interlockPid();
+	Test_windup();
+	Test_replay();
+
+	return Test_result("test_control");
+}
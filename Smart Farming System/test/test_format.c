@@ -0,0 +1,133 @@
+/**
+ * @file test_format.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host test of the number formatting (src/COMMON/format.c)
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * checked, for every 8-bit and every 16-bit value and the widths from 0 to a
+ * few more than the digits:
+ * - the text is the one of printf "%*u", 0 and the max values included
+ * - the count is the number of written characters and nothing is written
+ *   after them (there is no terminator)
+ *
+ */
+
+#include <string.h>
+#include "test.h"
+#include "format.h"
+
+/* widths checked, up to this one */
+#define TEST_MAX_WIDTH		8
+
+/* written after the text to find the characters written past it */
+#define TEST_GUARD			'#'
+
+/**
+ * @brief check the text of one value and width
+ *
+ * @return 1 when the text is the expected one
+ */
+static int Test_text(const char * pText, uint8 count, unsigned value, uint8 width)
+{
+	char expected[TEST_MAX_WIDTH + 2];
+	int length = snprintf(expected, sizeof(expected), "%*u", width, value);
+	uint8 k;
+
+	if((count != length) || memcmp(pText, expected, length))
+	{
+		return 0;
+	}
+	for(k = count; k < (TEST_MAX_WIDTH + FORMAT_U16_DIGITS); k++)
+	{
+		if(TEST_GUARD != pText[k])
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static void Test_u8(void)
+{
+	char text[TEST_MAX_WIDTH + FORMAT_U16_DIGITS];
+	unsigned failed = 0;
+	unsigned value;
+	uint8 width;
+	uint8 count;
+
+	for(value = 0; value <= 0xFF; value++)
+	{
+		for(width = 0; width <= TEST_MAX_WIDTH; width++)
+		{
+			memset(text, TEST_GUARD, sizeof(text));
+			count = Format_u8((uint8)value, text, width);
+			if(!Test_text(text, count, value, width) && (failed++ < 5))
+			{
+				printf("Format_u8(%u, %u) wrote \"%.*s\"\n", value, width, count, text);
+			}
+		}
+	}
+	TEST_EQUAL(failed, 0);
+
+	/* the ends and the padding, written out */
+	memset(text, TEST_GUARD, sizeof(text));
+	TEST_EQUAL(Format_u8(0, text, 0), 1);
+	TEST_CHECK(0 == memcmp(text, "0#", 2));
+	memset(text, TEST_GUARD, sizeof(text));
+	TEST_EQUAL(Format_u8(255, text, 0), 3);
+	TEST_CHECK(0 == memcmp(text, "255#", 4));
+	memset(text, TEST_GUARD, sizeof(text));
+	TEST_EQUAL(Format_u8(7, text, 3), 3);
+	TEST_CHECK(0 == memcmp(text, "  7#", 4));
+	memset(text, TEST_GUARD, sizeof(text));
+	TEST_EQUAL(Format_u8(100, text, 2), 3);
+	TEST_CHECK(0 == memcmp(text, "100#", 4));
+}
+
+static void Test_u16(void)
+{
+	char text[TEST_MAX_WIDTH + FORMAT_U16_DIGITS];
+	unsigned failed = 0;
+	unsigned value;
+	uint8 width;
+	uint8 count;
+
+	for(value = 0; value <= 0xFFFF; value++)
+	{
+		for(width = 0; width <= TEST_MAX_WIDTH; width++)
+		{
+			memset(text, TEST_GUARD, sizeof(text));
+			count = Format_u16((uint16)value, text, width);
+			if(!Test_text(text, count, value, width) && (failed++ < 5))
+			{
+				printf("Format_u16(%u, %u) wrote \"%.*s\"\n", value, width, count, text);
+			}
+		}
+	}
+	TEST_EQUAL(failed, 0);
+
+	memset(text, TEST_GUARD, sizeof(text));
+	TEST_EQUAL(Format_u16(0, text, 0), 1);
+	TEST_CHECK(0 == memcmp(text, "0#", 2));
+	memset(text, TEST_GUARD, sizeof(text));
+	TEST_EQUAL(Format_u16(65535, text, 0), 5);
+	TEST_CHECK(0 == memcmp(text, "65535#", 6));
+	memset(text, TEST_GUARD, sizeof(text));
+	TEST_EQUAL(Format_u16(42, text, 6), 6);
+	TEST_CHECK(0 == memcmp(text, "    42#", 7));
+	memset(text, TEST_GUARD, sizeof(text));
+	TEST_EQUAL(Format_u16(10000, text, 4), 5);
+	TEST_CHECK(0 == memcmp(text, "10000#", 6));
+}
+
+int main(void)
+{
+	Test_u8();
+	Test_u16();
+
+	return Test_result("test_format");
+}
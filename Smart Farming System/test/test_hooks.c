@@ -0,0 +1,42 @@
+/**
+ * @file test_hooks.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief kernel hooks of the host tests that run the scheduler
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+static StackType_t Test_IdleStack[configMINIMAL_STACK_SIZE];
+static StaticTask_t Test_IdleTCB;
+
+void vApplicationIdleHook(void)
+{
+}
+
+unsigned char ucApplicationIdleHookBusy(void)
+{
+	return 0;
+}
+
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char * pcTaskName)
+{
+	(void)xTask;
+
+	printf("stack overflow of %s\n", pcTaskName);
+	exit(EXIT_FAILURE);
+}
+
+void vApplicationGetIdleTaskMemory(StaticTask_t ** ppxIdleTaskTCBBuffer, StackType_t ** ppxIdleTaskStackBuffer, uint16_t * pusIdleTaskStackSize)
+{
+	*ppxIdleTaskTCBBuffer = &Test_IdleTCB;
+	*ppxIdleTaskStackBuffer = Test_IdleStack;
+	*pusIdleTaskStackSize = configMINIMAL_STACK_SIZE;
+}
@@ -0,0 +1,247 @@
+/**
+ * @file test_lcd.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host test of the lcd driver (src/ECU/lcd.c) over the HD44780 model
+ * (sim/src/ECU/lcd_model.c), with the time a character and a full screen take
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * the time is the bus clock of the model: the waits of the driver and its
+ * _delay_us() / _delay_ms() busy waits, the instructions between them are not
+ * counted (a few cycles each at 8 MHz). The blocking driver the frame buffer
+ * replaced waited 1 ms at each of the 4 steps of a byte, its write is kept
+ * here as it was (8-bit mode) and runs over the same model
+ *
+ * checked, for the driver and for the old blocking write:
+ * - the model shows the text written by a single character, a row and a
+ *   full screen
+ * - no byte is written while the lcd is still busy
+ * - a full screen takes less time with the driver, the time of each case is
+ *   printed
+ *
+ */
+
+#include <string.h>
+#include "test.h"
+#include "lcd.h"
+#include "lcd_timing.h"
+#include "lcd_model.h"
+
+/* src/ECU/lcd.c is built with its flush renamed for the simulation screen
+ * (CMakeLists.txt), the test calls the driver one */
+void LCD_driverFlush(void);
+
+/* lcd address of the first column in each row */
+static const uint8 Test_RowAddress[LCD_ROWS] = {0x00, 0x40, 0x14, 0x54};
+
+/* the interrupt flag of the atomic blocks */
+static uint8 Test_Interrupts = 0;
+
+void vPortEnableInterrupts(void)
+{
+	Test_Interrupts = 1;
+}
+
+void vPortDisableInterrupts(void)
+{
+	Test_Interrupts = 0;
+}
+
+uint8_t ucPortSimSREG(void)
+{
+	return Test_Interrupts ? (1 << SREG_I) : 0;
+}
+
+/**
+ * @brief the _delay_us() and _delay_ms() busy waits, the model samples the
+ * bus at their start like at the waits of the driver
+ *
+ */
+void vPortSimDelayUs(uint32_t ulMicroseconds)
+{
+	LCD_simWait(0);
+	LCD_modelDelay(ulMicroseconds * 1000UL);
+}
+
+/**
+ * @brief a byte of the blocking driver, 1 ms for Tas, Tpw - Tdsw, Tdsw and Th
+ *
+ */
+static void Test_oldWrite(uint8 rs, uint8 value)
+{
+	if(rs)
+	{
+		SET_BIT(LCD_CTRL_PORT,RS);
+	}
+	else
+	{
+		CLEAR_BIT(LCD_CTRL_PORT,RS);
+	}
+	CLEAR_BIT(LCD_CTRL_PORT,RW);
+	_delay_ms(1);
+	SET_BIT(LCD_CTRL_PORT,E);
+	_delay_ms(1);
+	LCD_DATA_PORT = value;
+	_delay_ms(1);
+	CLEAR_BIT(LCD_CTRL_PORT,E);
+	_delay_ms(1);
+}
+
+/**
+ * @brief the old LCD_displayStringRowColumn(), a cursor command and the text
+ *
+ */
+static void Test_oldString(uint8 row, uint8 col, const char * pText)
+{
+	Test_oldWrite(0, SET_CURSOR_LOCATION | (Test_RowAddress[row] + col));
+	while(*pText)
+	{
+		Test_oldWrite(1, *pText++);
+	}
+}
+
+/**
+ * @brief check the model shows the text at a row and column
+ *
+ */
+static void Test_shows(uint8 row, uint8 col, const char * pText)
+{
+	TEST_CHECK(0 == memcmp(&LCD_Model.Ddram[Test_RowAddress[row] + col], pText, strlen(pText)));
+}
+
+/**
+ * @brief the text of a full screen, different from the one before
+ *
+ */
+static void Test_screenText(char pText[LCD_ROWS][LCD_COLS + 1], char first)
+{
+	uint8 row;
+	uint8 col;
+
+	for(row = 0; row < LCD_ROWS; row++)
+	{
+		for(col = 0; col < LCD_COLS; col++)
+		{
+			pText[row][col] = (char)(first + ((row * LCD_COLS) + col) % 26);
+		}
+		pText[row][LCD_COLS] = '\0';
+	}
+}
+
+/**
+ * @brief bus time since a start, in us
+ *
+ */
+static double Test_us(uint64_t start)
+{
+	return (double)(LCD_Model.TimeNs - start) / 1000.0;
+}
+
+static void Test_driver(double * pScreenUs)
+{
+	char screen[LCD_ROWS][LCD_COLS + 1];
+	uint64_t start;
+	uint32 writes;
+	uint8 row;
+
+	/* the clear of the init is done before the first case */
+	LCD_init();
+	LCD_modelDelay(LCD_T_EXEC_CLEAR_US * 1000UL);
+
+	/* one character somewhere else than the last one written, a cursor
+	 * command and the character */
+	LCD_displayStringRowColumn(1, 5, "X");
+	start = LCD_Model.TimeNs;
+	writes = LCD_Model.BusWrites;
+	LCD_driverFlush();
+	printf("driver:   a character %8.1f us (%lu bus writes)\n", Test_us(start), (unsigned long)(LCD_Model.BusWrites - writes));
+	Test_shows(1, 5, "X");
+
+	/* a row, one cursor command for the 20 characters */
+	LCD_displayStringRowColumn(2, 0, "a whole row of text.");
+	start = LCD_Model.TimeNs;
+	LCD_driverFlush();
+	printf("driver:   a row       %8.1f us, %.1f us per character\n", Test_us(start), Test_us(start) / LCD_COLS);
+	Test_shows(2, 0, "a whole row of text.");
+
+	/* every cell changes */
+	Test_screenText(screen, 'A');
+	for(row = 0; row < LCD_ROWS; row++)
+	{
+		LCD_displayStringRowColumn(row, 0, screen[row]);
+	}
+	start = LCD_Model.TimeNs;
+	writes = LCD_Model.BusWrites;
+	LCD_driverFlush();
+	*pScreenUs = Test_us(start);
+	printf("driver:   full screen %8.1f us (%lu bus writes)\n", *pScreenUs, (unsigned long)(LCD_Model.BusWrites - writes));
+	for(row = 0; row < LCD_ROWS; row++)
+	{
+		Test_shows(row, 0, screen[row]);
+	}
+
+	/* the same screen again, nothing is sent */
+	for(row = 0; row < LCD_ROWS; row++)
+	{
+		LCD_displayStringRowColumn(row, 0, screen[row]);
+	}
+	start = LCD_Model.TimeNs;
+	LCD_driverFlush();
+	TEST_EQUAL(LCD_Model.TimeNs, start);
+
+	TEST_EQUAL(LCD_Model.BusyWrites, 0);
+}
+
+static void Test_blocking(double * pScreenUs)
+{
+	char screen[LCD_ROWS][LCD_COLS + 1];
+	uint64_t start;
+	uint8 row;
+
+	/* the old LCD_init() */
+	Test_oldWrite(0, TWO_LINE_LCD_Eight_BIT_MODE);
+	Test_oldWrite(0, CURSOR_OFF);
+	Test_oldWrite(0, CLEAR_COMMAND);
+	LCD_modelDelay(LCD_T_EXEC_CLEAR_US * 1000UL);
+
+	start = LCD_Model.TimeNs;
+	Test_oldString(1, 5, "X");
+	printf("blocking: a character %8.1f us (2 bus writes)\n", Test_us(start));
+	Test_shows(1, 5, "X");
+
+	start = LCD_Model.TimeNs;
+	Test_oldString(2, 0, "a whole row of text.");
+	printf("blocking: a row       %8.1f us, %.1f us per character\n", Test_us(start), Test_us(start) / LCD_COLS);
+	Test_shows(2, 0, "a whole row of text.");
+
+	/* the old screens rewrote every row */
+	Test_screenText(screen, 'a');
+	start = LCD_Model.TimeNs;
+	for(row = 0; row < LCD_ROWS; row++)
+	{
+		Test_oldString(row, 0, screen[row]);
+	}
+	*pScreenUs = Test_us(start);
+	printf("blocking: full screen %8.1f us (%u bus writes)\n", *pScreenUs, LCD_ROWS * (LCD_COLS + 1));
+	for(row = 0; row < LCD_ROWS; row++)
+	{
+		Test_shows(row, 0, screen[row]);
+	}
+
+	TEST_EQUAL(LCD_Model.BusyWrites, 0);
+}
+
+int main(void)
+{
+	double driverUs;
+	double blockingUs;
+
+	Test_driver(&driverUs);
+	Test_blocking(&blockingUs);
+
+	TEST_CHECK(driverUs < blockingUs);
+
+	return Test_result("test_lcd");
+}
@@ -0,0 +1,65 @@
+/**
+ * @file test_sensors.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host test of the fixed point sensor conversion against the float
+ * math it replaced
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * checked:
+ * - every 12 bit ADC code gives the value of (uint16)(adc * 12.20) / 100 in
+ *   single precision, the double of avr-gcc
+ * - above 4095, up to the CAL_MAX_VALUE a calibration table may return, the
+ *   product stays inside 32 bits and the value is at most 1 from the exact
+ *   adc * 1220 / 10000 (the float math overflows its uint16 cast there)
+ *
+ */
+
+#include "test.h"
+#include "sensors.h"
+#include "calibration.h"
+
+/**
+ * @brief the conversion of the sensors before the fixed point one
+ *
+ */
+static uint16 Test_floatConvert(uint16 adc, float scale)
+{
+	volatile float value = (float)adc * scale;
+
+	return (uint16)value / 100;
+}
+
+static void Test_sensor(const char * pName, uint32 scale_x100, float scale)
+{
+	const uint32 factor = SENSORS_Q_FACTOR(scale_x100);
+	uint32 adc;
+	uint32 exact;
+	uint16 value;
+	unsigned failures = Test_Failures;
+
+	for(adc = 0; adc < 4096; adc++)
+	{
+		TEST_EQUAL(Sensors_convert((uint16)adc, factor), Test_floatConvert((uint16)adc, scale));
+	}
+
+	for(adc = 4096; adc <= CAL_MAX_VALUE; adc++)
+	{
+		TEST_CHECK(((unsigned long long)adc * factor) <= 0xFFFFFFFFULL);
+		value = Sensors_convert((uint16)adc, factor);
+		exact = (adc * scale_x100) / 10000UL;
+		TEST_CHECK((value == exact) || (value == (exact + 1)) || ((value + 1) == exact));
+	}
+
+	printf("%s: factor %lu, %u failed checks\n", pName, (unsigned long)factor, Test_Failures - failures);
+}
+
+int main(void)
+{
+	Test_sensor("temperature", TEMP_SCALE_X100, 12.20f);
+	Test_sensor("humidity", HUMI_SCALE_X100, 12.20f);
+
+	return Test_result("test_sensors");
+}
@@ -0,0 +1,325 @@
+/**
+ * @file test_tickless.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host test of the timer 1 tick accounting of the ATmega32 port
+ * (FreeRTOS/Src/porttimer.h) over a model of the timer registers
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * the model counts in timer 1 counts (8 us): in CTC mode the counter clears
+ * on the count after it equals OCR1A and sets the compare flag, the tick
+ * interrupt runs when the flag is set and the interrupts are enabled. Each
+ * access of a timer register first lets the timer run for a few counts (the
+ * skew), so the code is also checked when the counter moves between its
+ * reads, the read-modify-write of TCNT1 is taken as one access
+ *
+ * checked, for each start count in the tick, idle time (2 ticks up to the
+ * longest suppressed period and above it), wake up count and skew:
+ * - the ticks stepped never pass the expected idle time, as vTaskStepTick()
+ *   asserts
+ * - at the next tick the tick count is exactly the elapsed counts / 125 and
+ *   the normal period is set back
+ * - the run time counter is the elapsed counts right after the sleep and at
+ *   the next tick, also with a compare match waiting with interrupts off
+ * - the missed compare path (the counter passes the new compare value while
+ *   it is set) is taken by some of the cases
+ *
+ */
+
+#include <stdlib.h>
+#include "test.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* the tick period, the compare value and the flag of the model timer */
+static uint16_t Test_Tcnt1;
+static uint16_t Test_Ocr1a;
+static uint8_t Test_Tifr;
+
+/* timer counts since the model started and counts added at each access */
+static uint32_t Test_Elapsed;
+static uint16_t Test_Skew;
+
+/* the interrupts are enabled, and the saved state of a critical section */
+static uint8_t Test_IntEnabled;
+static uint8_t Test_CriticalSaved;
+
+/* tick count of the model kernel and the highest it may be stepped to */
+static TickType_t Test_Ticks;
+static TickType_t Test_StepLimit;
+
+/* count of another interrupt ending the sleep, 0 for none */
+static uint32_t Test_WakeAt;
+
+/* the pre sleep processing cancels the sleep, the kernel aborts it */
+static uint8_t Test_Busy;
+static uint8_t Test_Abort;
+
+/* the counter went past the compare value (the missed compare) */
+static uint8_t Test_PastCompare;
+
+static void Test_count(uint32_t counts);
+
+/**
+ * @brief access of a timer register, the timer runs for the skew first
+ *
+ */
+static volatile uint16_t * Test_register16(uint16_t * pRegister)
+{
+	Test_count(Test_Skew);
+	return pRegister;
+}
+
+static volatile uint8_t * Test_register8(uint8_t * pRegister)
+{
+	Test_count(Test_Skew);
+	return pRegister;
+}
+
+#define TCNT1	(*Test_register16(&Test_Tcnt1))
+#define OCR1A	(*Test_register16(&Test_Ocr1a))
+#define TIFR	(*Test_register8(&Test_Tifr))
+
+static void Test_disable(void)
+{
+	Test_IntEnabled = 0;
+}
+
+static void Test_enable(void);
+
+#undef portDISABLE_INTERRUPTS
+#undef portENABLE_INTERRUPTS
+#undef portENTER_CRITICAL
+#undef portEXIT_CRITICAL
+#define portDISABLE_INTERRUPTS()	Test_disable()
+#define portENABLE_INTERRUPTS()		Test_enable()
+#define portENTER_CRITICAL()		do { Test_CriticalSaved = Test_IntEnabled; Test_disable(); } while(0)
+#define portEXIT_CRITICAL()			do { if(Test_CriticalSaved) { Test_enable(); } } while(0)
+
+static void Test_sleep(void);
+#define portTIMER_SLEEP()			Test_sleep()
+
+#include "../FreeRTOS/Src/porttimer.h"
+
+/**
+ * @brief the tick interrupt, the flag is cleared when the vector is taken
+ *
+ */
+static void Test_tickIsr(void)
+{
+	Test_Tifr &= (uint8_t)~portCOMPARE_MATCH_A_FLAG;
+	prvTimerPeriodEnded();
+	Test_Ticks++;
+}
+
+static void Test_enable(void)
+{
+	Test_IntEnabled = 1;
+	if(Test_Tifr & portCOMPARE_MATCH_A_FLAG)
+	{
+		Test_tickIsr();
+	}
+}
+
+static void Test_count(uint32_t counts)
+{
+	while(counts--)
+	{
+		Test_Elapsed++;
+		if(Test_Tcnt1 == Test_Ocr1a)
+		{
+			Test_Tcnt1 = 0;
+			Test_Tifr |= portCOMPARE_MATCH_A_FLAG;
+			if(Test_IntEnabled)
+			{
+				Test_tickIsr();
+			}
+		}
+		else
+		{
+			if(Test_Tcnt1 > Test_Ocr1a)
+			{
+				Test_PastCompare = 1;
+			}
+			Test_Tcnt1++;
+		}
+	}
+}
+
+/**
+ * @brief sei and sleep, until the tick interrupt or the other interrupt
+ *
+ */
+static void Test_sleep(void)
+{
+	TickType_t ticks = Test_Ticks;
+
+	Test_enable();
+	while((Test_Ticks == ticks) && (Test_Elapsed != Test_WakeAt))
+	{
+		Test_count(1);
+	}
+}
+
+eSleepModeStatus eTaskConfirmSleepModeStatus(void)
+{
+	return Test_Abort ? eAbortSleep : eStandardSleep;
+}
+
+void vTaskStepTick(const TickType_t xTicksToJump)
+{
+	TEST_CHECK((uint32_t)Test_Ticks + xTicksToJump <= Test_StepLimit);
+	Test_Ticks += xTicksToJump;
+}
+
+unsigned char ucApplicationIdleHookBusy(void)
+{
+	return Test_Busy;
+}
+
+/**
+ * @brief the timer and the kernel at the first tick
+ *
+ */
+static void Test_reset(void)
+{
+	Test_Tcnt1 = 0;
+	Test_Ocr1a = portCOUNTS_PER_TICK - 1;
+	Test_Tifr = 0;
+	Test_Elapsed = 0;
+	Test_Skew = 0;
+	Test_IntEnabled = 1;
+	Test_Ticks = 0;
+	Test_WakeAt = 0;
+	Test_Busy = 0;
+	Test_Abort = 0;
+	Test_PastCompare = 0;
+	ulRunTimeBase = 0;
+	ucTickInterruptFired = 0;
+}
+
+/**
+ * @brief one tickless sleep: the idle task calls in at start counts after a
+ * tick, another interrupt comes wake counts later (0 for none)
+ *
+ * @return the counter passed the compare value
+ */
+static uint8_t Test_suppress(uint16_t start, TickType_t idle, uint32_t wake, uint16_t skew)
+{
+	TickType_t clamped = (idle > portMAX_SUPPRESSED_TICKS) ? portMAX_SUPPRESSED_TICKS : idle;
+	unsigned failures = Test_Failures;
+	uint8_t past;
+
+	Test_count(start);
+	Test_StepLimit = (TickType_t)(Test_Ticks + clamped);
+	Test_WakeAt = wake ? (Test_Elapsed + wake) : 0;
+	Test_Skew = skew;
+
+	vPortSuppressTicksAndSleep(idle);
+
+	Test_Skew = 0;
+	past = Test_PastCompare;
+	TEST_CHECK(Test_IntEnabled);
+	TEST_EQUAL(ulPortGetRunTimeCounter(), Test_Elapsed);
+
+	/* the tick that follows */
+	do
+	{
+		Test_count(1);
+	} while(Test_Tcnt1 != 0);
+
+	TEST_EQUAL((uint32_t)Test_Ticks * portCOUNTS_PER_TICK, Test_Elapsed);
+	TEST_EQUAL(ulPortGetRunTimeCounter(), Test_Elapsed);
+	TEST_EQUAL(Test_Ocr1a, portCOUNTS_PER_TICK - 1);
+
+	if(failures != Test_Failures)
+	{
+		printf("  start %u, idle %u, wake %lu, skew %u\n", start, idle, (unsigned long)wake, skew);
+	}
+
+	return past;
+}
+
+static void Test_sleeps(void)
+{
+	static const uint16_t starts[] = {0, 1, 60, 123, 124};
+	static const TickType_t idles[] = {2, 3, 10, portMAX_SUPPRESSED_TICKS, portMAX_SUPPRESSED_TICKS + 1, portMAX_DELAY};
+	uint32_t wakes[12];
+	unsigned cases = 0;
+	unsigned missed = 0;
+	unsigned s, i, w;
+	uint16_t skew;
+	uint32_t end;
+
+	for(s = 0; s < (sizeof(starts) / sizeof(starts[0])); s++)
+	{
+		for(i = 0; i < (sizeof(idles) / sizeof(idles[0])); i++)
+		{
+			/* counts from the call to the end of the idle time */
+			end = ((uint32_t)((idles[i] > portMAX_SUPPRESSED_TICKS) ? portMAX_SUPPRESSED_TICKS : idles[i]) * portCOUNTS_PER_TICK) - starts[s];
+			wakes[0] = 0;
+			wakes[1] = 1;
+			wakes[2] = portCOUNTS_PER_TICK - 1;
+			wakes[3] = portCOUNTS_PER_TICK;
+			wakes[4] = portCOUNTS_PER_TICK + 1;
+			wakes[5] = end / 2;
+			wakes[6] = end - 8;
+			wakes[7] = end - 4;
+			wakes[8] = end - 3;
+			wakes[9] = end - 2;
+			wakes[10] = end - 1;
+			wakes[11] = end;
+
+			for(w = 0; w < (sizeof(wakes) / sizeof(wakes[0])); w++)
+			{
+				for(skew = 0; skew <= 3; skew++)
+				{
+					Test_reset();
+					missed += Test_suppress(starts[s], idles[i], wakes[w], skew);
+					cases++;
+
+					/* a second sleep goes on from the state left by the first */
+					missed += Test_suppress(starts[s], idles[i], wakes[w], skew);
+					cases++;
+				}
+			}
+		}
+	}
+
+	printf("%u sleeps, %u with a missed compare\n", cases, missed);
+	TEST_CHECK(missed > 0);
+}
+
+static void Test_noSleep(void)
+{
+	/* the pre sleep processing cancels the sleep */
+	Test_reset();
+	Test_Busy = 1;
+	(void)Test_suppress(60, 10, 0, 1);
+
+	/* a task was readied */
+	Test_reset();
+	Test_Abort = 1;
+	(void)Test_suppress(60, 10, 0, 1);
+
+	/* a tick is waiting when the idle task calls in */
+	Test_reset();
+	Test_disable();
+	Test_count(portCOUNTS_PER_TICK);
+	TEST_EQUAL(Test_Ticks, 0);
+	TEST_EQUAL(ulPortGetRunTimeCounter(), Test_Elapsed);
+	Test_StepLimit = 10;
+	vPortSuppressTicksAndSleep(10);
+	TEST_EQUAL(Test_Ticks, 1);
+	TEST_EQUAL(ulPortGetRunTimeCounter(), Test_Elapsed);
+}
+
+int main(void)
+{
+	Test_sleeps();
+	Test_noSleep();
+
+	return Test_result("test_tickless");
+}
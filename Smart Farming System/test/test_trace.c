@@ -0,0 +1,300 @@
+/**
+ * @file test_trace.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host round trip test of the trace recorder (src/APP/trace.c) and the
+ * decoder (tools/tracedec.c)
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * the test stands in for the run time counter and the uart: it records a
+ * known sequence of events at chosen times, keeps the frames of Trace_flush()
+ * with some terminal text between them, and runs tracedec on that stream
+ *
+ * checked:
+ * - every event comes out of tracedec in order with its time, rebuilt from
+ *   the SYNC events when the high 16 bits of the time change
+ * - a frame refused by a full uart is sent by the next flush, once
+ * - nothing is sent while paused, the events go out after the resume
+ * - the events that find the buffer full come out as one LOST event with
+ *   their count, in front of the next recorded event
+ * - nothing is recorded while tracing is off
+ * - the event, lost and bad frame counts and the notify latency of tracedec
+ * - the scan latency of tracedec, from the ADC interrupt notifying SENS to
+ *   CTRL running in the updates of that reading, and not for a CTRL wake up
+ *   after SENS waits again
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "test.h"
+#include "trace.h"
+#include "uart.h"
+
+/* events recorded while the buffer is never flushed, more than it holds */
+#define TEST_FLOOD_EVENTS	40
+
+/* events the buffer takes, one entry is kept free and an event needs room
+ * for a SYNC and a LOST event in front of it */
+#define TEST_FLOOD_KEPT		(TRACE_BUFFER_EVENTS - 3)
+
+#define TEST_LINE			160
+
+/* the terminal text between the frames, 'T' followed by a bad count */
+static const char Test_Text[] = "TRACE ON\r\nCAL OK\r\n";
+
+/* names of the tasks in tracedec, by priority */
+static const char * const Test_TaskNames[] =
+{
+	"IDLE", "prio1", "DISP", "SENS", "TERM", "CHECK", "CTRL", "prio7"
+};
+
+typedef struct
+{
+	uint32 Time;
+	uint8 Event;
+	const char * pName;
+	uint8 Task;
+} Test_Event_t;
+
+/* two readings, the first turns an actuator and the second does not, then a
+ * PID slot ends and CHECK turns an actuator without a new reading */
+static const Test_Event_t Test_Scan[] =
+{
+	{0x00030010UL, TRACE_EV_NOTIFY_ISR,  "NOTIFY_ISR",  3},
+	{0x0003001BUL, TRACE_EV_SWITCH_IN,   "SWITCH_IN",   3},
+	{0x00030020UL, TRACE_EV_NOTIFY,      "NOTIFY",      5},
+	{0x00030022UL, TRACE_EV_SWITCH_IN,   "SWITCH_IN",   5},
+	{0x00030030UL, TRACE_EV_NOTIFY,      "NOTIFY",      6},
+	{0x00030032UL, TRACE_EV_SWITCH_IN,   "SWITCH_IN",   6},
+	{0x00030034UL, TRACE_EV_NOTIFY_WAIT, "NOTIFY_WAIT", 6},
+	{0x00030035UL, TRACE_EV_SWITCH_IN,   "SWITCH_IN",   5},
+	{0x00030036UL, TRACE_EV_NOTIFY_WAIT, "NOTIFY_WAIT", 5},
+	{0x00030037UL, TRACE_EV_SWITCH_IN,   "SWITCH_IN",   3},
+	{0x00030038UL, TRACE_EV_NOTIFY_WAIT, "NOTIFY_WAIT", 3},
+	{0x00030100UL, TRACE_EV_NOTIFY_ISR,  "NOTIFY_ISR",  3},
+	{0x0003010BUL, TRACE_EV_SWITCH_IN,   "SWITCH_IN",   3},
+	{0x0003010CUL, TRACE_EV_NOTIFY_WAIT, "NOTIFY_WAIT", 3},
+	{0x00030200UL, TRACE_EV_SWITCH_IN,   "SWITCH_IN",   5},
+	{0x00030201UL, TRACE_EV_NOTIFY,      "NOTIFY",      6},
+	{0x00030203UL, TRACE_EV_SWITCH_IN,   "SWITCH_IN",   6},
+	{0x00030204UL, TRACE_EV_NOTIFY_WAIT, "NOTIFY_WAIT", 6}
+};
+
+/* the stream the decoder reads */
+static uint8 Test_Stream[4096];
+static unsigned Test_StreamLen = 0;
+static uint8 Test_UartFull = 0;
+
+/* the run time counter */
+static uint32 Test_Now = 0;
+
+/* the lines tracedec must print for the events, in order */
+static char Test_Lines[128][TEST_LINE];
+static unsigned Test_LineCount = 0;
+
+/* events in the stream, the SYNC events included */
+static unsigned Test_Events = 0;
+
+void vPortEnterCritical(void)
+{
+}
+
+void vPortExitCritical(void)
+{
+}
+
+uint32_t ulPortGetRunTimeCounter(void)
+{
+	return Test_Now;
+}
+
+ERROR_t UART_writeFrame(const uint8 * pBuf, uint8 len)
+{
+	TEST_CHECK(len < UART_TX_BUFFER_SIZE);
+	if(Test_UartFull || ((Test_StreamLen + len) > sizeof(Test_Stream)))
+	{
+		return E_NOK;
+	}
+
+	memcpy(&Test_Stream[Test_StreamLen], pBuf, len);
+	Test_StreamLen += len;
+
+	return E_OK;
+}
+
+static void Test_text(void)
+{
+	memcpy(&Test_Stream[Test_StreamLen], Test_Text, sizeof(Test_Text) - 1);
+	Test_StreamLen += sizeof(Test_Text) - 1;
+}
+
+/**
+ * @brief the line of tracedec for an event at a time (8 us counts)
+ *
+ */
+static void Test_expect(uint32 time, const char * pName, const char * pObject)
+{
+	snprintf(Test_Lines[Test_LineCount], TEST_LINE, "%14.3f ms  %-14s %s\n",
+			 ((double)time * 8.0) / 1000.0, pName, pObject);
+	Test_LineCount++;
+}
+
+/**
+ * @brief record an event at a time
+ *
+ */
+static void Test_record(uint32 time, uint8 event, uint8 object)
+{
+	Test_Now = time;
+	Trace_record(event, object);
+}
+
+static void Test_encode(void)
+{
+	char text[16];
+	unsigned k;
+
+	/* off, nothing recorded */
+	Test_record(0x00010000UL, TRACE_EV_SWITCH_IN, 1);
+
+	Trace_start();
+
+	/* SYNC 1 in front of the first event, SENS is notified by DISP and runs
+	 * 11 counts later after SYNC 2 */
+	Test_record(0x0001FFF0UL, TRACE_EV_SWITCH_IN, 2);
+	Test_record(0x0001FFFAUL, TRACE_EV_NOTIFY, 3);
+	Test_record(0x00020005UL, TRACE_EV_SWITCH_IN, 3);
+	Test_record(0x00020010UL, TRACE_EV_QUEUE_SEND, 0x5A);
+	Test_expect(0x0001FFF0UL, "SWITCH_IN", "DISP");
+	Test_expect(0x0001FFFAUL, "NOTIFY", "SENS");
+	Test_expect(0x00020005UL, "SWITCH_IN", "SENS");
+	Test_expect(0x00020010UL, "QUEUE_SEND", "obj 5a");
+	Test_Events += 6;
+
+	/* the uart is full, the events wait for the next flush */
+	Test_UartFull = 1;
+	Trace_flush();
+	TEST_EQUAL(Test_StreamLen, 0);
+	Test_UartFull = 0;
+	Trace_pause();
+	Trace_flush();
+	TEST_EQUAL(Test_StreamLen, 0);
+	Trace_resume();
+	Trace_flush();
+	Test_text();
+
+	/* nobody flushes, the events after the first TEST_FLOOD_KEPT are lost */
+	for(k = 0; k < TEST_FLOOD_EVENTS; k++)
+	{
+		Test_record(0x00020100UL + k, TRACE_EV_DELAY, 4);
+		if(k < TEST_FLOOD_KEPT)
+		{
+			Test_expect(0x00020100UL + k, "DELAY", "TERM");
+			Test_Events++;
+		}
+	}
+	Trace_flush();
+	Test_text();
+
+	/* the next event brings SYNC 3 and the LOST count in front of it */
+	Test_record(0x00030000UL, TRACE_EV_EVENT_SET, 0x21);
+	snprintf(text, sizeof(text), "%u events", TEST_FLOOD_EVENTS - TEST_FLOOD_KEPT);
+	Test_expect(0x00030000UL, "LOST", text);
+	Test_expect(0x00030000UL, "EVENT_SET", "obj 21");
+	Test_Events += 3;
+
+	/* a reading that turns an actuator: SENS, CHECK and CTRL run in turn,
+	 * CTRL 34 counts after the ADC interrupt */
+	for(k = 0; k < (sizeof(Test_Scan) / sizeof(Test_Scan[0])); k++)
+	{
+		Test_record(Test_Scan[k].Time, Test_Scan[k].Event, Test_Scan[k].Task);
+		Test_expect(Test_Scan[k].Time, Test_Scan[k].pName, Test_TaskNames[Test_Scan[k].Task]);
+		Test_Events++;
+	}
+
+	/* off again, the recorded events are still sent */
+	Trace_stop();
+	Test_record(0x00030100UL, TRACE_EV_SWITCH_IN, 5);
+	Trace_flush();
+	Trace_flush();
+}
+
+static void Test_decode(void)
+{
+	char path[] = "test_trace.XXXXXX";
+	char command[512];
+	char line[TEST_LINE];
+	char summary[TEST_LINE];
+	unsigned k = 0;
+	int summaryFound = 0;
+	int latencyFound = 0;
+	int scanFound = 0;
+	FILE * pOut;
+	int fd;
+
+	fd = mkstemp(path);
+	TEST_CHECK(fd >= 0);
+	if(fd < 0)
+	{
+		return;
+	}
+	TEST_EQUAL(write(fd, Test_Stream, Test_StreamLen), Test_StreamLen);
+	close(fd);
+
+	snprintf(command, sizeof(command), "\"%s\" \"%s\"", TEST_TRACEDEC, path);
+	pOut = popen(command, "r");
+	TEST_CHECK(pOut != NULL);
+	if(NULL == pOut)
+	{
+		unlink(path);
+		return;
+	}
+
+	snprintf(summary, sizeof(summary), "%u events, %u lost, 0 bad frames\n",
+			 Test_Events, TEST_FLOOD_EVENTS - TEST_FLOOD_KEPT);
+
+	while(fgets(line, sizeof(line), pOut))
+	{
+		if(k < Test_LineCount)
+		{
+			if(strcmp(line, Test_Lines[k]))
+			{
+				printf("event %u: got    %sevent %u: wanted %s", k, line, k, Test_Lines[k]);
+				Test_Failures++;
+			}
+			k++;
+		}
+		else if(0 == strcmp(line, summary))
+		{
+			summaryFound = 1;
+		}
+		else if(0 == strcmp(line, "SENS notify -> running latency: 3 samples, min 88 us, avg 88 us, max 88 us\n"))
+		{
+			latencyFound = 1;
+		}
+		else if(0 == strcmp(line, "SENS scan -> CTRL running latency: 1 samples, min 272 us, avg 272 us, max 272 us\n"))
+		{
+			scanFound = 1;
+		}
+	}
+
+	TEST_EQUAL(pclose(pOut), 0);
+	unlink(path);
+
+	TEST_EQUAL(k, Test_LineCount);
+	TEST_CHECK(summaryFound);
+	TEST_CHECK(latencyFound);
+	TEST_CHECK(scanFound);
+}
+
+int main(void)
+{
+	Test_encode();
+	Test_decode();
+
+	return Test_result("test_trace");
+}
@@ -0,0 +1,254 @@
+/**
+ * @file test_uart.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host test of the uart driver (src/MCAL/uart.c) over the simulated
+ * kernel, the test stands in for the USART: it writes UDR and runs the RX
+ * ISR for each received byte and takes UDR after each UDRE ISR
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * checked:
+ * - with the interrupts disabled a full TX buffer is drained by polling, the
+ *   oldest byte first
+ * - bytes pushed through the RX ISR are read by UART_read() in order
+ * - a full RX buffer drops the extra bytes and keeps the first ones
+ * - a task writing more than the TX buffer holds sleeps, a lower priority
+ *   task runs meanwhile, and all the bytes leave through the UDRE ISR in order
+ * - with the interrupts disabled for good (the stack overflow hook) the
+ *   queued bytes are sent by UART_flushPolled() and the buffer is left empty
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <avr/interrupt.h>
+#include "test.h"
+#include "uart.h"
+#include "task.h"
+
+/* bytes sent before the scheduler starts, more than the TX buffer holds */
+#define TEST_EARLY_BYTES	40
+#define TEST_EARLY_QUEUED	(UART_TX_BUFFER_SIZE - 1)
+
+/* bytes of the blocking write, several times the TX buffer */
+#define TEST_LONG_BYTES		150
+
+/* host time of one simulated byte and the time the whole test may take */
+#define TEST_BYTE_US		100
+#define TEST_LIMIT_US		5000000ULL
+
+#define TEST_STACK			200
+
+static StackType_t Test_MainStack[TEST_STACK];
+static StaticTask_t Test_MainTCB;
+static StackType_t Test_LowStack[TEST_STACK];
+static StaticTask_t Test_LowTCB;
+
+/* bytes the "USART" receives, one RX interrupt each */
+static const uint8 * volatile Test_pRx = NULL;
+static volatile unsigned Test_RxLeft = 0;
+
+/* bytes taken from UDR after the UDRE interrupts */
+static uint8 Test_Sent[TEST_EARLY_BYTES + TEST_LONG_BYTES];
+static volatile unsigned Test_SentCount = 0;
+
+/* run time of the low priority task */
+static volatile uint32 Test_LowCount = 0;
+
+/**
+ * @brief receive the next byte, the RX complete vector of the test
+ *
+ */
+static void Test_rxIsr(void)
+{
+	if(Test_RxLeft)
+	{
+		UDR = *Test_pRx;
+		Test_pRx++;
+		Test_RxLeft--;
+		USART_RXC_vect();
+	}
+}
+
+/**
+ * @brief the data register is empty, the UDRE vector of the test, the driver
+ * wrote UDR when it leaves the interrupt enabled
+ *
+ */
+static void Test_udreIsr(void)
+{
+	USART_UDRE_vect();
+	if(BIT_IS_SET(UCSRB,UDRIE) && (Test_SentCount < sizeof(Test_Sent)))
+	{
+		Test_Sent[Test_SentCount++] = UDR;
+	}
+}
+
+/**
+ * @brief host thread of the USART, one byte each way every byte time
+ *
+ */
+static void * Test_usartThread(void * pvParam)
+{
+	(void)pvParam;
+
+	while(ullPortSimTimeUs() < TEST_LIMIT_US)
+	{
+		vPortSimSleepUs(TEST_BYTE_US);
+		if(Test_RxLeft)
+		{
+			vPortSimRaiseIsr(USART_RXC_vect_num);
+		}
+		if(BIT_IS_SET(UCSRB,UDRIE))
+		{
+			vPortSimRaiseIsr(USART_UDRE_vect_num);
+		}
+	}
+
+	printf("test_uart: time out\n");
+	exit(EXIT_FAILURE);
+}
+
+/**
+ * @brief the "USART" receives the bytes
+ *
+ */
+static void Test_receive(const uint8 * pData, unsigned len)
+{
+	taskENTER_CRITICAL();
+	Test_pRx = pData;
+	Test_RxLeft = len;
+	taskEXIT_CRITICAL();
+}
+
+static void Test_low(void * pvParam)
+{
+	(void)pvParam;
+
+	while(1)
+	{
+		/* the critical section lets the interrupts in at its end */
+		taskENTER_CRITICAL();
+		Test_LowCount++;
+		taskEXIT_CRITICAL();
+	}
+}
+
+static void Test_main(void * pvParam)
+{
+	static const uint8 hello[] = "hello";
+	static uint8 flood[UART_RX_BUFFER_SIZE + 4];
+	static char text[TEST_LONG_BYTES + 1];
+	uint8 buff[sizeof(flood)];
+	uint32 lowBefore;
+	unsigned k;
+
+	(void)pvParam;
+
+	/* the queued part of the early bytes goes out through the ISR */
+	while(Test_SentCount < TEST_EARLY_QUEUED)
+	{
+		vTaskDelay(1);
+	}
+	vTaskDelay(5);
+	TEST_EQUAL(Test_SentCount, TEST_EARLY_QUEUED);
+	for(k = 0; k < TEST_EARLY_QUEUED; k++)
+	{
+		TEST_EQUAL(Test_Sent[k], 'A' + (TEST_EARLY_BYTES - TEST_EARLY_QUEUED) + k);
+	}
+	TEST_CHECK(BIT_IS_CLEAR(UCSRB,UDRIE));
+
+	/* received bytes */
+	Test_receive(hello, 5);
+	memset(buff, 0, sizeof(buff));
+	TEST_EQUAL(UART_read(buff, 5, 100), 5);
+	TEST_CHECK(0 == memcmp(buff, hello, 5));
+	TEST_EQUAL(UART_read(buff, 1, 10), 0);
+
+	/* RX buffer overflow, nobody reads while the bytes arrive */
+	for(k = 0; k < sizeof(flood); k++)
+	{
+		flood[k] = (uint8)(0x80 + k);
+	}
+	Test_receive(flood, sizeof(flood));
+	while(Test_RxLeft)
+	{
+		vTaskDelay(1);
+	}
+	TEST_EQUAL(UART_read(buff, sizeof(buff), 0), UART_RX_BUFFER_SIZE - 1);
+	TEST_CHECK(0 == memcmp(buff, flood, UART_RX_BUFFER_SIZE - 1));
+
+	/* blocking write, the low priority task runs while this one waits */
+	for(k = 0; k < TEST_LONG_BYTES; k++)
+	{
+		text[k] = (char)('a' + (k % 26));
+	}
+	text[TEST_LONG_BYTES] = '\0';
+	Test_SentCount = 0;
+	lowBefore = Test_LowCount;
+	UART_sendString(text);
+	TEST_CHECK(Test_LowCount != lowBefore);
+	/* at most a full buffer is left, the byte of the ISR that woke this task
+	 * is taken by Test_udreIsr() when the ISR ends */
+	TEST_CHECK(Test_SentCount >= (TEST_LONG_BYTES - UART_TX_BUFFER_SIZE));
+
+	while(BIT_IS_SET(UCSRB,UDRIE))
+	{
+		vTaskDelay(1);
+	}
+	TEST_EQUAL(Test_SentCount, TEST_LONG_BYTES);
+	TEST_CHECK(0 == memcmp(Test_Sent, text, TEST_LONG_BYTES));
+
+	/* a short report with the interrupts disabled stays queued until it is
+	 * flushed by polling, nothing is sent while the interrupts are enabled */
+	UART_flushPolled();
+	TEST_EQUAL(Test_SentCount, TEST_LONG_BYTES);
+	portDISABLE_INTERRUPTS();
+	UDR = 0;
+	UART_sendString("STACK OVERFLOW LOW\r\n");
+	TEST_EQUAL(UDR, 0);
+	TEST_CHECK(BIT_IS_SET(UCSRB,UDRIE));
+	UART_flushPolled();
+	TEST_EQUAL(UDR, '\n');
+	TEST_CHECK(BIT_IS_CLEAR(UCSRB,UDRIE));
+	TEST_EQUAL(UART_writeFrame((const uint8 *)text, UART_TX_BUFFER_SIZE - 1), E_OK);
+
+	exit(Test_result("test_uart"));
+}
+
+int main(void)
+{
+	pthread_t thread;
+	unsigned k;
+
+	UART_init();
+	TEST_EQUAL(UCSRB, (1<<RXCIE) | (1<<RXEN) | (1<<TXEN));
+
+	/* UDRE is a status bit the driver can not clear, the data register is
+	 * always empty for the polled bytes */
+	SET_BIT(UCSRA,UDRE);
+
+	/* the interrupts are disabled until the scheduler starts */
+	for(k = 0; k < TEST_EARLY_BYTES; k++)
+	{
+		UART_sendByte((uint8)('A' + k));
+	}
+	TEST_EQUAL(UDR, 'A' + (TEST_EARLY_BYTES - TEST_EARLY_QUEUED) - 1);
+	TEST_CHECK(BIT_IS_SET(UCSRB,UDRIE));
+
+	vPortSimInstallIsr(USART_RXC_vect_num, Test_rxIsr);
+	vPortSimInstallIsr(USART_UDRE_vect_num, Test_udreIsr);
+	if(0 != pthread_create(&thread, NULL, Test_usartThread, NULL))
+	{
+		return EXIT_FAILURE;
+	}
+
+	xTaskCreateStatic(Test_main, "MAIN", TEST_STACK, NULL, 3, Test_MainStack, &Test_MainTCB);
+	xTaskCreateStatic(Test_low, "LOW", TEST_STACK, NULL, 1, Test_LowStack, &Test_LowTCB);
+	vTaskStartScheduler();
+
+	return EXIT_FAILURE;
+}
@@ -0,0 +1,363 @@
+/**
+ * @file tracedec.c
+ * @author Ahmed Sabry (ahmed.sabry10696@gmail.com)
+ * @brief host decoder of the kernel trace sent after the 'T' terminal command,
+ * prints the events timeline and the wake up latency histogram of each task,
+ * and the one of the sensor scan to the relay pins
+ * @version 0.1
+ * @date 2021-05-12
+ *
+ * @copyright Copyright (c) 2021
+ *
+ * build: cc -O2 -I../inc/APP -I../inc/COMMON -o tracedec tracedec.c
+ * use:   tracedec [-q] [-u us_per_count] [file]   (stdin when no file)
+ *
+ * the input is the raw uart stream, text and frames of other commands are
+ * skipped, a frame is only taken when its sum is right
+ *
+ * the scan latency starts when the ADC interrupt notifies SENS with a new
+ * reading and ends when CTRL runs, it is only taken when CTRL is notified
+ * before SENS waits for the next reading, so for the updates of that reading
+ * that changed an actuator. CTRL writes the relay pins as soon as it runs
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#include "trace.h"
+
+/* timer 1 counts at 8 MHz / 64 */
+#define DEFAULT_US_PER_COUNT	8.0
+
+/* task priorities of main.c, the trace identifies a task by its priority */
+#define MAX_TASKS				8
+#define TASK_SENS				3
+#define TASK_CTRL				6
+static const char * const TaskNames[MAX_TASKS] =
+{
+	"IDLE", "prio1", "DISP", "SENS", "TERM", "CHECK", "CTRL", "prio7"
+};
+
+/* latency buckets, bucket k counts latencies below 2^(k+3) us */
+#define BUCKETS					16
+
+typedef struct
+{
+	int Pending;			/* notified and not running yet */
+	uint64_t NotifyTime;
+	unsigned long Count;
+	double Min;
+	double Max;
+	double Sum;
+	unsigned long Buckets[BUCKETS];
+} Latency_t;
+
+static const char * const EventNames[TRACE_EV_COUNT] =
+{
+	"SYNC", "LOST", "SWITCH_IN", "NOTIFY", "NOTIFY_ISR", "NOTIFY_WAIT", "DELAY",
+	"QUEUE_SEND", "QUEUE_SEND_ISR", "QUEUE_RECEIVE", "QUEUE_BLOCK",
+	"EVENT_SET", "EVENT_WAIT"
+};
+
+static Latency_t Latency[MAX_TASKS];
+
+/* sensor scan to relay pins, the time of the scan SENS is handling */
+static Latency_t ScanLatency;
+static int ScanPending = 0;
+static uint64_t ScanTime;
+static unsigned long Lost = 0;
+static unsigned long Events = 0;
+static unsigned long BadFrames = 0;
+
+static int Quiet = 0;
+static double UsPerCount = DEFAULT_US_PER_COUNT;
+
+/* time of the events, rebuilt from the SYNC events */
+static uint32_t High = 0;
+static uint64_t Wraps = 0;
+static uint32_t LastTime = 0;
+static int Synced = 0;
+
+static int isTaskEvent(uint8_t code)
+{
+	return (code >= TRACE_EV_SWITCH_IN) && (code <= TRACE_EV_DELAY);
+}
+
+static void latencyAdd(Latency_t * pLat, double us)
+{
+	unsigned k = 0;
+
+	while((k < (BUCKETS - 1)) && (us >= (double)(8u << k)))
+	{
+		k++;
+	}
+	pLat->Buckets[k]++;
+
+	if((0 == pLat->Count) || (us < pLat->Min))
+	{
+		pLat->Min = us;
+	}
+	if(us > pLat->Max)
+	{
+		pLat->Max = us;
+	}
+	pLat->Sum += us;
+	pLat->Count++;
+}
+
+static void decodeEvent(const uint8_t * pEvent)
+{
+	uint8_t code = pEvent[0];
+	uint8_t object = pEvent[1];
+	uint16_t low = (uint16_t)(pEvent[2] | (pEvent[3] << 8));
+	uint32_t time;
+	uint64_t fullTime;
+	double us;
+
+	Events++;
+
+	if(TRACE_EV_SYNC == code)
+	{
+		High = low;
+		Synced = 1;
+		return;
+	}
+
+	if(!Synced)
+	{
+		/* the start of the stream was missed, wait for a SYNC */
+		return;
+	}
+
+	time = (High << 16) | low;
+	/* the 32 bit counter of the target wraps after about 9.5 hours */
+	if(time < LastTime)
+	{
+		Wraps++;
+	}
+	LastTime = time;
+	fullTime = (Wraps << 32) | time;
+	us = (double)fullTime * UsPerCount;
+
+	if(TRACE_EV_LOST == code)
+	{
+		Lost += object;
+		/* the latencies across the gap can not be trusted */
+		for(unsigned k = 0; k < MAX_TASKS; k++)
+		{
+			Latency[k].Pending = 0;
+		}
+		ScanPending = 0;
+		ScanLatency.Pending = 0;
+	}
+	else if(((TRACE_EV_NOTIFY == code) || (TRACE_EV_NOTIFY_ISR == code)) && (object < MAX_TASKS))
+	{
+		if(!Latency[object].Pending)
+		{
+			Latency[object].Pending = 1;
+			Latency[object].NotifyTime = fullTime;
+		}
+
+		if((TRACE_EV_NOTIFY_ISR == code) && (TASK_SENS == object))
+		{
+			/* a new reading from the ADC interrupt */
+			ScanPending = 1;
+			ScanTime = fullTime;
+		}
+		else if((TASK_CTRL == object) && ScanPending && !ScanLatency.Pending)
+		{
+			ScanLatency.Pending = 1;
+			ScanLatency.NotifyTime = ScanTime;
+		}
+	}
+	else if((TRACE_EV_SWITCH_IN == code) && (object < MAX_TASKS))
+	{
+		if(Latency[object].Pending)
+		{
+			latencyAdd(&Latency[object], (double)(fullTime - Latency[object].NotifyTime) * UsPerCount);
+			Latency[object].Pending = 0;
+		}
+
+		if((TASK_CTRL == object) && ScanLatency.Pending)
+		{
+			latencyAdd(&ScanLatency, (double)(fullTime - ScanLatency.NotifyTime) * UsPerCount);
+			ScanLatency.Pending = 0;
+		}
+	}
+	else if((TRACE_EV_NOTIFY_WAIT == code) && (TASK_SENS == object))
+	{
+		/* the updates of the reading are done */
+		ScanPending = 0;
+	}
+
+	if(!Quiet)
+	{
+		printf("%14.3f ms  %-14s ", us / 1000.0, (code < TRACE_EV_COUNT) ? EventNames[code] : "?");
+		if(TRACE_EV_LOST == code)
+		{
+			printf("%u events\n", object);
+		}
+		else if(isTaskEvent(code))
+		{
+			printf("%s\n", (object < MAX_TASKS) ? TaskNames[object] : "?");
+		}
+		else
+		{
+			printf("obj %02x\n", object);
+		}
+	}
+}
+
+static void printHistogram(const char * pName, const Latency_t * pLat)
+{
+	unsigned k;
+	unsigned long most;
+
+	if(0 == pLat->Count)
+	{
+		return;
+	}
+
+	printf("\n%s latency: %lu samples, min %.0f us, avg %.0f us, max %.0f us\n",
+		   pName, pLat->Count, pLat->Min, pLat->Sum / pLat->Count, pLat->Max);
+
+	most = 1;
+	for(k = 0; k < BUCKETS; k++)
+	{
+		if(pLat->Buckets[k] > most)
+		{
+			most = pLat->Buckets[k];
+		}
+	}
+
+	for(k = 0; k < BUCKETS; k++)
+	{
+		if(0 == pLat->Buckets[k])
+		{
+			continue;
+		}
+		if(k < (BUCKETS - 1))
+		{
+			printf("  < %7u us %8lu ", 8u << k, pLat->Buckets[k]);
+		}
+		else
+		{
+			printf("  >=%7u us %8lu ", 8u << (k - 1), pLat->Buckets[k]);
+		}
+		for(unsigned long bar = 0; bar < ((pLat->Buckets[k] * 50) + most - 1) / most; bar++)
+		{
+			putchar('#');
+		}
+		putchar('\n');
+	}
+}
+
+static void printHistograms(void)
+{
+	char name[32];
+	unsigned t;
+
+	printf("\n%lu events, %lu lost, %lu bad frames\n", Events, Lost, BadFrames);
+
+	for(t = 0; t < MAX_TASKS; t++)
+	{
+		snprintf(name, sizeof(name), "%s notify -> running", TaskNames[t]);
+		printHistogram(name, &Latency[t]);
+	}
+
+	printHistogram("SENS scan -> CTRL running", &ScanLatency);
+}
+
+int main(int argc, char ** argv)
+{
+	uint8_t stream[TRACE_FRAME_SIZE(TRACE_FRAME_EVENTS)];
+	unsigned len = 0;
+	unsigned need;
+	unsigned k;
+	uint8_t sum;
+	FILE * pIn = stdin;
+	int opt;
+	int c;
+
+	while((opt = getopt(argc, argv, "qu:")) != -1)
+	{
+		switch(opt)
+		{
+			case 'q':
+				Quiet = 1;
+				break;
+			case 'u':
+				UsPerCount = atof(optarg);
+				break;
+			default:
+				fprintf(stderr, "use: %s [-q] [-u us_per_count] [file]\n", argv[0]);
+				return 1;
+		}
+	}
+
+	if(optind < argc)
+	{
+		pIn = fopen(argv[optind], "rb");
+		if(NULL == pIn)
+		{
+			perror(argv[optind]);
+			return 1;
+		}
+	}
+
+	while((c = fgetc(pIn)) != EOF)
+	{
+		stream[len++] = (uint8_t)c;
+
+		while(len > 0)
+		{
+			/* look for the start of a frame and a valid number of events */
+			if((TRACE_FRAME_START != stream[0]) ||
+			   ((len >= 2) && ((0 == stream[1]) || (stream[1] > TRACE_FRAME_EVENTS))))
+			{
+				memmove(stream, &stream[1], --len);
+				continue;
+			}
+
+			need = (len >= 2) ? TRACE_FRAME_SIZE(stream[1]) : 2;
+			if(len < need)
+			{
+				break;
+			}
+
+			sum = 0;
+			for(k = 1; k < (need - 1); k++)
+			{
+				sum += stream[k];
+			}
+
+			if(sum == stream[need - 1])
+			{
+				for(k = 0; k < stream[1]; k++)
+				{
+					decodeEvent(&stream[2 + (k * TRACE_EVENT_SIZE)]);
+				}
+				len = 0;
+			}
+			else
+			{
+				/* not a frame (text or a lost byte), try again from the next byte */
+				BadFrames++;
+				memmove(stream, &stream[1], --len);
+			}
+		}
+	}
+
+	if(pIn != stdin)
+	{
+		fclose(pIn);
+	}
+
+	printHistograms();
+
+	return 0;
+}